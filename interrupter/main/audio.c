@@ -17,8 +17,18 @@
 // Includes
 // -----------------------------------------------------------------------------
 #include "audio.h"
+#include "clip.h"
+#include "driver/gptimer.h"
 #include "esp_adc/adc_continuous.h"
+#include "esp_log.h"
+#include "esp_partition.h"
 #include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "pulse.h"
+#include "sdkconfig.h"
+#include "tasks.h"
+#include <string.h>
 
 // -----------------------------------------------------------------------------
 // Macros and Constants
@@ -32,6 +42,14 @@
 
 #define MIDPOINT 2110
 
+#define CLIP_PARTITION CONFIG_INTERRUPT_CLIP_PARTITION
+#define CLIP_VOICES CONFIG_INTERRUPT_CLIP_VOICES
+#define CLIP_BLOCK CONFIG_INTERRUPT_CLIP_BLOCK // Samples mixed at a time
+#define CLIP_TIMER_HZ 10000000
+#define CLIP_TRIGGER_QUEUE 8
+
+#define TAG "audio"
+
 // -----------------------------------------------------------------------------
 // Static Variables
 // -----------------------------------------------------------------------------
@@ -56,8 +74,34 @@ typedef struct
     size_t size;
 } adc_evt_t;
 
+typedef struct
+{
+    uint16_t index;
+    uint8_t velocity;
+} clip_trigger_t;
+
 static void (*pwm_duty_cb)(uint8_t duty);
 
+static volatile audio_input_counters_t input_counters = {0};
+
+// Always written, so the scope screen costs nothing to the input path
+static volatile int16_t input_ring[AUDIO_INPUT_RING];
+static volatile uint32_t input_pos = 0;
+
+// Clips stay mapped, the mixer reads the samples straight from flash
+static const clip_header_t *clips = NULL;
+static clip_voice_t clip_voices[CLIP_VOICES];
+static uint16_t clip_selected = 0;
+
+// Ping-pong duty buffer: the timer plays one half while the task mixes the
+// other
+static uint8_t clip_duty[2 * CLIP_BLOCK];
+static volatile uint32_t clip_play_pos = 0;
+
+static gptimer_handle_t clip_timer = NULL;
+static TaskHandle_t clip_task_handle = NULL;
+static QueueHandle_t clip_trigger_queue = NULL;
+
 // --- ISR: only notify task ---
 static bool IRAM_ATTR adc_conv_done_cb(adc_continuous_handle_t handle,
                                        const adc_continuous_evt_data_t *edata,
@@ -65,17 +109,79 @@ static bool IRAM_ATTR adc_conv_done_cb(adc_continuous_handle_t handle,
 {
     adc_digi_output_data_t *p =
         (adc_digi_output_data_t *)(edata->conv_frame_buffer);
-    uint16_t raw = p->type2.data;
+    int32_t sample = (int32_t)p->type2.data - 2048;
 
-    int mapped_val = raw * 255 / 4095;
-    if (mapped_val < 0) mapped_val = 0;
-    if (mapped_val > 255) mapped_val = 255;
+    input_counters.level_sum += sample < 0 ? -sample : sample;
+    input_counters.samples++;
+    input_ring[input_pos % AUDIO_INPUT_RING] = sample;
+    input_pos++;
 
-    if (pwm_duty_cb) pwm_duty_cb(mapped_val);
+    if (pwm_duty_cb) pwm_duty_cb(pulse_duty(sample));
 
     return true;
 }
 
+// One sample per alarm from RAM, the task refills the half just played
+static bool IRAM_ATTR clip_timer_cb(gptimer_handle_t timer,
+                                    const gptimer_alarm_event_data_t *edata,
+                                    void *user_data)
+{
+    uint32_t pos = clip_play_pos;
+    if (pwm_duty_cb) pwm_duty_cb(clip_duty[pos]);
+
+    pos = pos + 1 == 2 * CLIP_BLOCK ? 0 : pos + 1;
+    clip_play_pos = pos;
+
+    BaseType_t woken = pdFALSE;
+    if (pos % CLIP_BLOCK == 0)
+    {
+        task_wake_stamp(TASK_CLIP);
+        vTaskNotifyGiveFromISR(clip_task_handle, &woken);
+    }
+    return woken == pdTRUE;
+}
+
+static void clip_fill(uint8_t *duty)
+{
+    clip_trigger_t trigger;
+    while (xQueueReceive(clip_trigger_queue, &trigger, 0) == pdTRUE)
+    {
+        const int8_t *samples;
+        uint32_t length;
+        if (clip_get(clips, trigger.index, &samples, &length))
+            clip_voice_start(clip_voices, CLIP_VOICES, samples, length,
+                             trigger.velocity + 1);
+    }
+
+    bool active = false;
+    for (int i = 0; i < CLIP_VOICES; i++) active |= clip_voices[i].pos != NULL;
+
+    // Output off between clips rather than at the midpoint duty
+    if (!active)
+    {
+        memset(duty, 0, CLIP_BLOCK);
+        return;
+    }
+
+    int16_t mix[CLIP_BLOCK];
+    clip_mix(clip_voices, CLIP_VOICES, mix, CLIP_BLOCK);
+    for (int i = 0; i < CLIP_BLOCK; i++) duty[i] = pulse_duty(mix[i]);
+}
+
+static void clip_task(void *arg)
+{
+    while (1)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        task_woken(TASK_CLIP);
+        if (state != AUDIO_PLAYING) continue;
+
+        // Refill the half the timer just left
+        uint32_t half = clip_play_pos < CLIP_BLOCK ? 1 : 0;
+        clip_fill(&clip_duty[half * CLIP_BLOCK]);
+    }
+}
+
 void audio_init(void)
 {
     adc_continuous_handle_cfg_t handle_cfg = {
@@ -106,23 +212,130 @@ void audio_init(void)
     adc_continuous_register_event_callbacks(adc_handle, &cbs, NULL);
 }
 
+esp_err_t audio_clips_init(void)
+{
+    const esp_partition_t *part = esp_partition_find_first(
+        ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, CLIP_PARTITION);
+    if (part == NULL)
+    {
+        ESP_LOGW(TAG, "No '%s' partition", CLIP_PARTITION);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    const void *ptr;
+    esp_partition_mmap_handle_t mmap;
+    esp_err_t err = esp_partition_mmap(part, 0, part->size,
+                                       ESP_PARTITION_MMAP_DATA, &ptr, &mmap);
+    if (err != ESP_OK) return err;
+
+    const clip_header_t *hdr = clip_open(ptr, part->size);
+    if (hdr == NULL)
+    {
+        esp_partition_munmap(mmap);
+        ESP_LOGW(TAG, "No clip bank in '%s'", CLIP_PARTITION);
+        return ESP_ERR_INVALID_VERSION;
+    }
+
+    clip_trigger_queue = xQueueCreate(CLIP_TRIGGER_QUEUE,
+                                      sizeof(clip_trigger_t));
+    clip_task_handle = task_start(TASK_CLIP, clip_task, NULL);
+
+    gptimer_config_t timer_config = {
+        .clk_src = GPTIMER_CLK_SRC_DEFAULT,
+        .direction = GPTIMER_COUNT_UP,
+        .resolution_hz = CLIP_TIMER_HZ,
+    };
+    ESP_ERROR_CHECK(gptimer_new_timer(&timer_config, &clip_timer));
+    gptimer_event_callbacks_t timer_cbs = {.on_alarm = clip_timer_cb};
+    ESP_ERROR_CHECK(
+        gptimer_register_event_callbacks(clip_timer, &timer_cbs, NULL));
+    gptimer_alarm_config_t alarm_config = {
+        .alarm_count = (CLIP_TIMER_HZ + hdr->sample_rate / 2) /
+                       hdr->sample_rate,
+        .reload_count = 0,
+        .flags.auto_reload_on_alarm = true,
+    };
+    ESP_ERROR_CHECK(gptimer_set_alarm_action(clip_timer, &alarm_config));
+    ESP_ERROR_CHECK(gptimer_enable(clip_timer));
+
+    clips = hdr;
+    ESP_LOGI(TAG, "%d clips at %lu Hz, %lu bytes of samples",
+             hdr->clip_count, hdr->sample_rate, hdr->data_size);
+
+    return ESP_OK;
+}
+
 void audio_listen(void)
 {
     if (state == AUDIO_LISTENING) return;
+    audio_stop();
     state = AUDIO_LISTENING;
     adc_continuous_start(adc_handle);
 }
 
+// Plays the clip bank through the jack output stage, the ADC stays off
+void audio_play_clips(void)
+{
+    if (state == AUDIO_PLAYING || clips == NULL) return;
+    audio_stop();
+
+    memset(clip_voices, 0, sizeof(clip_voices));
+    xQueueReset(clip_trigger_queue);
+    memset(clip_duty, 0, sizeof(clip_duty));
+    clip_play_pos = 0;
+
+    state = AUDIO_PLAYING;
+    gptimer_set_raw_count(clip_timer, 0);
+    gptimer_start(clip_timer);
+}
+
 void audio_stop(void)
 {
-    if (state == AUDIO_IDLE) return;
+    if (state == AUDIO_LISTENING)
+        adc_continuous_stop(adc_handle);
+    else if (state == AUDIO_PLAYING)
+        gptimer_stop(clip_timer);
     state = AUDIO_IDLE;
-    adc_continuous_stop(adc_handle);
 }
 
+audio_state_t audio_get_state(void) { return state; }
+
+bool audio_clip_trigger(uint16_t index, uint8_t velocity)
+{
+    if (state != AUDIO_PLAYING || index >= clips->clip_count) return false;
+
+    clip_trigger_t trigger = {.index = index, .velocity = velocity & 0x7F};
+    return xQueueSend(clip_trigger_queue, &trigger, 0) == pdTRUE;
+}
+
+uint16_t audio_clip_count(void) { return clips ? clips->clip_count : 0; }
+
+void audio_clip_select(uint16_t index)
+{
+    if (index < audio_clip_count()) clip_selected = index;
+}
+
+uint16_t audio_clip_get_selected(void) { return clip_selected; }
+
 void audio_set_pwm_duty_update_cb(void (*cb)(uint8_t duty))
 {
     pwm_duty_cb = cb;
 }
 
 void audio_set_volume(uint8_t vol) { volume = vol; }
+
+void audio_get_input_counters(audio_input_counters_t *out)
+{
+    *out = input_counters;
+}
+
+// Latest count samples, oldest first. Not locked: at 16 kHz the callback
+// overwrites the oldest one or two while they are copied.
+void audio_get_input_samples(int16_t *samples, uint16_t count)
+{
+    if (count > AUDIO_INPUT_RING) count = AUDIO_INPUT_RING;
+
+    uint32_t pos = input_pos - count;
+    for (uint16_t i = 0; i < count; i++, pos++)
+        samples[i] = input_ring[pos % AUDIO_INPUT_RING];
+}
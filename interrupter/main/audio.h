@@ -27,11 +27,14 @@ extern "C"
 // -----------------------------------------------------------------------------
 // Includes
 // -----------------------------------------------------------------------------
+#include "esp_err.h"
+#include <stdbool.h>
 #include <stdint.h>
 
 // -----------------------------------------------------------------------------
 // Macros and Constants
 // -----------------------------------------------------------------------------
+#define AUDIO_INPUT_RING 512 // Latest input samples kept for the scope
 
 // -----------------------------------------------------------------------------
 // Type Definitions
@@ -39,9 +42,17 @@ extern "C"
 typedef enum 
 {
     AUDIO_LISTENING,
-    AUDIO_IDLE
+    AUDIO_IDLE,
+    AUDIO_PLAYING // Clips from flash
 } audio_state_t;
 
+// Free running, written by the ADC callback only
+typedef struct
+{
+    uint32_t level_sum; // Sum of |sample|, full scale is 2048
+    uint32_t samples;
+} audio_input_counters_t;
+
 // -----------------------------------------------------------------------------
 // Inline Function Definitions
 // -----------------------------------------------------------------------------
@@ -55,6 +66,15 @@ void audio_stop(void);
 audio_state_t audio_get_state(void);
 void audio_set_pwm_duty_update_cb(void (*cb)(uint8_t duty));
 void audio_set_volume(uint8_t saturation_factor);
+void audio_get_input_counters(audio_input_counters_t *counters);
+void audio_get_input_samples(int16_t *samples, uint16_t count);
+
+esp_err_t audio_clips_init(void);
+void audio_play_clips(void);
+bool audio_clip_trigger(uint16_t index, uint8_t velocity);
+uint16_t audio_clip_count(void);
+void audio_clip_select(uint16_t index);
+uint16_t audio_clip_get_selected(void);
 
 #ifdef __cplusplus
 }
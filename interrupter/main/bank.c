@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file bank.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "bank.h"
+#include "envelope.h"
+#include "sdkconfig.h"
+#include "tables.h"
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+const bank_preset_t *bank_open(const uint8_t *data, size_t size,
+                               uint16_t *count)
+{
+    const bank_header_t *hdr = (const bank_header_t *)data;
+
+    if (size < sizeof(*hdr)) return NULL;
+    if (hdr->magic != BANK_MAGIC || hdr->version != BANK_VERSION) return NULL;
+    if (hdr->preset_size != sizeof(bank_preset_t)) return NULL;
+    if (hdr->preset_count == 0 || hdr->preset_count > BANK_MAX_PRESETS)
+        return NULL;
+    if (sizeof(*hdr) + hdr->preset_count * sizeof(bank_preset_t) > size)
+        return NULL;
+
+    *count = hdr->preset_count;
+    return (const bank_preset_t *)(data + sizeof(*hdr));
+}
+
+// The preset built from the Kconfig settings
+void bank_preset_default(bank_preset_t *preset)
+{
+    memset(preset, 0, sizeof(*preset));
+    strncpy(preset->name, "Default", BANK_NAME_LEN);
+    preset->attack_ms = CONFIG_INTERRUPT_ENV_ATTACK_MS;
+    preset->decay_ms = CONFIG_INTERRUPT_ENV_DECAY_MS;
+    preset->release_ms = CONFIG_INTERRUPT_ENV_RELEASE_MS;
+    preset->sustain = CONFIG_INTERRUPT_ENV_SUSTAIN;
+#if CONFIG_INTERRUPT_ENV_SHAPE_LINEAR
+    preset->env_shape = ENV_SHAPE_LINEAR;
+#else
+    preset->env_shape = ENV_SHAPE_EXPONENTIAL;
+#endif
+    preset->vel_curve = VEL_CURVE_DEFAULT;
+    preset->polyphony = CONFIG_INTERRUPT_VOICE_COUNT;
+    preset->pd_max_us = CONFIG_INTERRUPT_PD_MAX;
+    preset->max_duty = CONFIG_INTERRUPT_MAX_DUTY;
+    preset->tremolo = CONFIG_INTERRUPT_TREMOLO_DEPTH;
+    preset->vibrato_cents = CONFIG_INTERRUPT_VIBRATO_DEPTH_CENTS;
+    preset->lfo_rate_dhz = CONFIG_INTERRUPT_LFO_RATE_DHZ;
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file bank.h
+ * @brief Voice preset bank image format
+ *
+ * Shared by the firmware and the host builder (tools/mkbank). An image is
+ * a bank_header_t followed by preset_count bank_preset_t records, program
+ * change n selects record n. All fields are little endian.
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+#ifndef BANK_H
+#define BANK_H
+
+// clang-format off
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define BANK_MAGIC 0x314B4250 // "PBK1"
+#define BANK_VERSION 1
+#define BANK_MAX_PRESETS 128 // One per program
+#define BANK_NAME_LEN 12
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t preset_count;
+    uint16_t preset_size; // sizeof(bank_preset_t) when built
+    uint16_t reserved;
+} bank_header_t;
+
+typedef struct
+{
+    char name[BANK_NAME_LEN]; // NUL padded, not terminated when full
+    uint16_t attack_ms;
+    uint16_t decay_ms;
+    uint16_t release_ms;
+    uint8_t sustain;        // %
+    uint8_t env_shape;      // env_shape_t
+    uint8_t vel_curve;      // vel_curve_t
+    uint8_t polyphony;      // Voices, clamped to VOICE_COUNT
+    uint16_t pd_max_us;     // Pulse width at full velocity
+    uint8_t max_duty;       // % of the period, per voice
+    uint8_t tremolo;        // % at full modulation wheel
+    uint16_t vibrato_cents; // At full modulation wheel
+    uint16_t lfo_rate_dhz;
+    uint16_t reserved;
+} bank_preset_t;
+
+_Static_assert(sizeof(bank_header_t) == 12, "bank_header_t layout");
+_Static_assert(sizeof(bank_preset_t) == 32, "bank_preset_t layout");
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+const bank_preset_t *bank_open(const uint8_t *data, size_t size,
+                               uint16_t *count);
+void bank_preset_default(bank_preset_t *preset);
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
+
+#endif /* !BANK_H */
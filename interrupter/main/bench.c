@@ -0,0 +1,306 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file bench.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "bench.h"
+#include "clip.h"
+#include "midi_parse.h"
+#include "output.h"
+#include "output_mock.h"
+#include "pulse.h"
+#include "sdkconfig.h"
+#include "voice.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef ESP_PLATFORM
+#include "esp_cpu.h"
+#else
+#include <time.h>
+#endif
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#ifdef ESP_PLATFORM
+#define BENCH_UNIT "cycles"
+#define BENCH_PLATFORM CONFIG_IDF_TARGET
+#else
+#define BENCH_UNIT "ns"
+#define BENCH_PLATFORM "host"
+#endif
+
+#define BENCH_BATCHES 10
+#define BENCH_CALLS 1000
+
+#define MIX_BLOCK CONFIG_INTERRUPT_CLIP_BLOCK
+#define MIX_VOICES 4
+#define MIX_CLIP_LEN (MIX_BLOCK * 8)
+#define DUTY_SAMPLES 256
+#define USB_PACKETS 16 // One 64 byte bulk transfer
+#define UART_BYTES 48
+#define BENCH_NOTES 4
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+typedef struct
+{
+    const char *name;
+    uint32_t items;
+    void (*setup)(void);
+    void (*run)(uint32_t calls);
+} bench_case_t;
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static volatile uint32_t sink;
+
+static int8_t mix_clip[MIX_CLIP_LEN];
+static clip_voice_t mix_voices[MIX_VOICES];
+
+static uint8_t usb_transfer[USB_PACKETS * 4];
+static uint8_t uart_stream[UART_BYTES];
+
+static pulse_sched_t sched;
+static uint32_t sched_now;
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static inline uint32_t bench_now(void)
+{
+#ifdef ESP_PLATFORM
+    return esp_cpu_get_cycle_count();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+#endif
+}
+
+static void voice_setup(void)
+{
+    voice_init(CONFIG_INTERRUPT_CONTROL_RATE_HZ);
+    for (int i = 0; i < BENCH_NOTES; i++)
+    {
+        midi_message_t msg = {
+            .type = MIDI_MSG_NOTE, .note = 48 + 7 * i, .velocity = 100};
+        voice_handle_message(&msg);
+    }
+}
+
+static void mix_setup(void)
+{
+    for (int i = 0; i < MIX_CLIP_LEN; i++) mix_clip[i] = (int8_t)(i * 37);
+}
+
+static void mix_run(uint32_t calls)
+{
+    int16_t out[MIX_BLOCK];
+
+    for (uint32_t i = 0; i < calls; i++)
+    {
+        // All voices busy, restarted together once the clip ends
+        if (mix_voices[0].pos == NULL)
+        {
+            for (int v = 0; v < MIX_VOICES; v++)
+                clip_voice_start(mix_voices, MIX_VOICES, mix_clip,
+                                 MIX_CLIP_LEN, 100);
+        }
+        clip_mix(mix_voices, MIX_VOICES, out, MIX_BLOCK);
+        sink += out[i % MIX_BLOCK];
+    }
+}
+
+static void duty_run(uint32_t calls)
+{
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < calls; i++)
+    {
+        for (int32_t s = 0; s < DUTY_SAMPLES; s++)
+            acc += pulse_duty(s * 16 - PULSE_SAMPLE_MAX - 1 + (int32_t)i);
+    }
+    sink += acc;
+}
+
+// Note on, note off, CC and bend packets, as midi_in_cb() decodes them
+static void usb_setup(void)
+{
+    static const uint8_t packets[4][4] = {{0x09, 0x90, 60, 100},
+                                          {0x08, 0x80, 60, 0},
+                                          {0x0B, 0xB0, 1, 64},
+                                          {0x0E, 0xE0, 0, 64}};
+    for (int i = 0; i < USB_PACKETS; i++)
+        memcpy(&usb_transfer[i * 4], packets[i % 4], 4);
+}
+
+static void usb_run(uint32_t calls)
+{
+    for (uint32_t i = 0; i < calls; i++)
+    {
+        for (int p = 0; p < USB_PACKETS * 4; p += 4)
+        {
+            if ((usb_transfer[p] & 0x0F) < 0x8) continue;
+
+            midi_message_t msg;
+            if (midi_decode(usb_transfer[p + 1], usb_transfer[p + 2],
+                            usb_transfer[p + 3], &msg))
+                sink += msg.note;
+        }
+    }
+}
+
+// Running status notes with a clock byte in between, as on a DIN cable
+static void uart_setup(void)
+{
+    for (int i = 0; i < UART_BYTES; i++)
+    {
+        if (i % 8 == 7)
+            uart_stream[i] = 0xF8;
+        else if (i == 0)
+            uart_stream[i] = 0x90;
+        else
+            uart_stream[i] = (uint8_t)(40 + i) & 0x7F;
+    }
+}
+
+static void uart_run(uint32_t calls)
+{
+    midi_parser_t parser;
+    midi_parser_init(&parser);
+
+    for (uint32_t i = 0; i < calls; i++)
+    {
+        for (int b = 0; b < UART_BYTES; b++)
+        {
+            midi_message_t msg;
+            if (midi_parser_feed(&parser, uart_stream[b], &msg))
+                sink += msg.note;
+        }
+    }
+}
+
+static void period_run(uint32_t calls)
+{
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < calls; i++)
+        acc += voice_pitch_to_period((int32_t)(i * 7919) & 0x7FFFFF);
+    sink += acc;
+}
+
+static void tick_run(uint32_t calls)
+{
+    for (uint32_t i = 0; i < calls; i++) voice_tick();
+    sink += voice_active_count();
+}
+
+static void sched_setup(void)
+{
+    voice_setup();
+    pulse_sched_reset(&sched);
+    sched_now = 0;
+}
+
+// One pulse timer alarm per call, time advances as the ISR would see it
+static void sched_run(uint32_t calls)
+{
+    for (uint32_t i = 0; i < calls; i++)
+    {
+        uint32_t in;
+        sink += pulse_sched_alarm(&sched, sched_now, voice_next_pulse, &in);
+        sched_now += in;
+    }
+}
+
+static void output_setup(void)
+{
+    output_init(&output_mock);
+    output_arm();
+}
+
+static void output_run(uint32_t calls)
+{
+    for (uint32_t i = 0; i < calls; i++) output_pulse((uint16_t)i);
+}
+
+static const bench_case_t cases[] = {
+    {"clip_mix", MIX_BLOCK, mix_setup, mix_run},
+    {"pulse_duty", DUTY_SAMPLES, NULL, duty_run},
+    {"midi_usb", USB_PACKETS, usb_setup, usb_run},
+    {"midi_uart", UART_BYTES, uart_setup, uart_run},
+    {"note_period", 1, NULL, period_run},
+    {"voice_tick", BENCH_NOTES, voice_setup, tick_run},
+    {"pulse_sched", BENCH_NOTES, sched_setup, sched_run},
+    {"output_pulse", 1, output_setup, output_run},
+};
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+// Runs the cases whose name contains filter (all when NULL), returns the
+// number of cases run
+int bench_run(const char *filter, bench_report_t report, void *ctx)
+{
+    int run = 0;
+
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++)
+    {
+        const bench_case_t *bc = &cases[c];
+        if (filter && strstr(bc->name, filter) == NULL) continue;
+
+        if (bc->setup) bc->setup();
+        bc->run(BENCH_CALLS / 10); // Warm the caches
+
+        uint32_t best = UINT32_MAX;
+        uint64_t total = 0;
+        for (int b = 0; b < BENCH_BATCHES; b++)
+        {
+            uint32_t t0 = bench_now();
+            bc->run(BENCH_CALLS);
+            uint32_t dt = bench_now() - t0;
+
+            if (dt < best) best = dt;
+            total += dt;
+        }
+
+        bench_result_t result = {
+            .name = bc->name,
+            .items = bc->items,
+            .calls = BENCH_CALLS,
+            .best = (double)best / BENCH_CALLS,
+            .mean = (double)total / BENCH_BATCHES / BENCH_CALLS,
+        };
+        report(&result, ctx);
+        run++;
+    }
+
+    return run;
+}
+
+int bench_format(const bench_result_t *result, const char *revision,
+                 char *buf, size_t len)
+{
+    return snprintf(buf, len,
+                    "{\"bench\":\"%s\",\"platform\":\"%s\","
+                    "\"revision\":\"%s\",\"unit\":\"%s\",\"items\":%u,"
+                    "\"calls\":%u,\"best\":%.2f,\"mean\":%.2f}",
+                    result->name, BENCH_PLATFORM, revision, BENCH_UNIT,
+                    (unsigned)result->items, (unsigned)result->calls,
+                    result->best, result->mean);
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file bench.h
+ * @brief Microbenchmarks of the hot paths
+ *
+ * Times the kernels that run in ISRs or per sample: the clip mixer, the
+ * duty mapping, USB and serial MIDI decoding, note to period conversion,
+ * the control tick, the pulse scheduler and the output dispatch. Each case
+ * runs a batch of calls several times and keeps the best and the mean
+ * time per call, in CPU cycles on the target (esp_cpu_get_cycle_count) and
+ * in nanoseconds on the host.
+ *
+ * Results are printed as JSON lines, one per case, so runs of different
+ * commits can be compared by a script. Built in the firmware with
+ * CONFIG_INTERRUPT_BENCH and on the host as tools/bench.
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+// clang-format off
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include <stddef.h>
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+typedef struct
+{
+    const char *name;
+    uint32_t items; // Samples, bytes or notes handled per call
+    uint32_t calls; // Calls per batch
+    double best;    // Time per call, fastest batch
+    double mean;    // Time per call, all batches
+} bench_result_t;
+
+typedef void (*bench_report_t)(const bench_result_t *result, void *ctx);
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+int bench_run(const char *filter, bench_report_t report, void *ctx);
+int bench_format(const bench_result_t *result, const char *revision,
+                 char *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
+
+#endif /* !BENCH_H */
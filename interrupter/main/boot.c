@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file boot.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "boot.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <stdatomic.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define TAG "boot"
+
+#define ALL_PHASES ((1u << BOOT_PHASE_COUNT) - 1)
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static const char *phase_names[BOOT_PHASE_COUNT] = {
+    [BOOT_MAIN] = "main",       [BOOT_SETTINGS] = "settings",
+    [BOOT_ARMABLE] = "armable", [BOOT_UI] = "ui",
+    [BOOT_USB] = "usb",         [BOOT_DONE] = "done",
+};
+
+static uint32_t stamps[BOOT_PHASE_COUNT];
+static atomic_uint marked = 0;
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+void boot_mark(boot_phase_t phase)
+{
+    unsigned bit = 1u << phase;
+    if (atomic_load(&marked) & bit) return;
+
+    stamps[phase] = esp_timer_get_time();
+    // The task that completes the set logs it, once
+    if ((atomic_fetch_or(&marked, bit) | bit) != ALL_PHASES) return;
+
+    for (int p = 0; p < BOOT_PHASE_COUNT; p++)
+        ESP_LOGI(TAG, "%-8s %6lu us", phase_names[p], stamps[p]);
+    ESP_LOGI(TAG, "Armable after %lu ms, UI after %lu ms",
+             stamps[BOOT_ARMABLE] / 1000, stamps[BOOT_UI] / 1000);
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file boot.h
+ * @brief Boot phase timestamps
+ *
+ * Each phase is stamped with esp_timer time, which starts with the
+ * application: the ROM and the bootloader come before it. Stamping only
+ * stores the time. The profile is logged once every phase is in, so the
+ * console does not slow the path to an armable output.
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+#ifndef BOOT_H
+#define BOOT_H
+
+// clang-format off
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+typedef enum
+{
+    BOOT_MAIN,     // app_main entered
+    BOOT_SETTINGS, // Settings restored
+    BOOT_ARMABLE,  // Output and trigger up
+    BOOT_UI,       // Screen and knob up
+    BOOT_USB,      // USB host up
+    BOOT_DONE,     // Everything else initialized
+    BOOT_PHASE_COUNT
+} boot_phase_t;
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+// Any task, the first stamp of a phase counts
+void boot_mark(boot_phase_t phase);
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
+
+#endif /* !BOOT_H */
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file clip.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "clip.h"
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static uint32_t age_counter = 0;
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+const clip_header_t *clip_open(const uint8_t *data, size_t size)
+{
+    const clip_header_t *hdr = (const clip_header_t *)data;
+
+    if (size < sizeof(*hdr)) return NULL;
+    if (hdr->magic != CLIP_MAGIC || hdr->version != CLIP_VERSION) return NULL;
+    if (hdr->clip_count == 0 || hdr->sample_rate == 0) return NULL;
+    if (hdr->index_offset + (uint64_t)hdr->clip_count * sizeof(clip_entry_t) >
+            size ||
+        hdr->data_offset + (uint64_t)hdr->data_size > size)
+        return NULL;
+
+    // Every clip must lie within the sample data
+    const clip_entry_t *index =
+        (const clip_entry_t *)(data + hdr->index_offset);
+    for (uint16_t i = 0; i < hdr->clip_count; i++)
+    {
+        if ((uint64_t)index[i].offset + index[i].length > hdr->data_size)
+            return NULL;
+    }
+
+    return hdr;
+}
+
+bool clip_get(const clip_header_t *hdr, uint16_t index, const int8_t **samples,
+              uint32_t *length)
+{
+    if (index >= hdr->clip_count) return false;
+
+    const uint8_t *base = (const uint8_t *)hdr;
+    const clip_entry_t *entry =
+        (const clip_entry_t *)(base + hdr->index_offset) + index;
+    *samples = (const int8_t *)(base + hdr->data_offset + entry->offset);
+    *length = entry->length;
+    return true;
+}
+
+// Free voice first, else the oldest one is cut
+void clip_voice_start(clip_voice_t *voices, int count, const int8_t *samples,
+                      uint32_t length, uint16_t gain)
+{
+    clip_voice_t *v = &voices[0];
+
+    for (int i = 0; i < count; i++)
+    {
+        if (voices[i].pos == NULL)
+        {
+            v = &voices[i];
+            break;
+        }
+        if (voices[i].age < v->age) v = &voices[i];
+    }
+
+    v->pos = samples;
+    v->end = samples + length;
+    v->gain = gain;
+    v->age = ++age_counter;
+}
+
+// Sum of the active voices, signed 12 bits with saturation
+void clip_mix(clip_voice_t *voices, int count, int16_t *out, int n)
+{
+    int32_t acc[n];
+    memset(acc, 0, sizeof(acc));
+
+    for (int i = 0; i < count; i++)
+    {
+        clip_voice_t *v = &voices[i];
+        if (v->pos == NULL) continue;
+
+        int len = v->end - v->pos < n ? (int)(v->end - v->pos) : n;
+        for (int s = 0; s < len; s++) acc[s] += v->pos[s] * v->gain;
+
+        v->pos += len;
+        if (v->pos >= v->end) v->pos = NULL;
+    }
+
+    // 8 bit samples, Q7 gain: >> 3 gives 12 bits
+    for (int s = 0; s < n; s++)
+    {
+        int32_t sample = acc[s] >> 3;
+        if (sample > CLIP_SAMPLE_MAX) sample = CLIP_SAMPLE_MAX;
+        if (sample < -CLIP_SAMPLE_MAX - 1) sample = -CLIP_SAMPLE_MAX - 1;
+        out[s] = (int16_t)sample;
+    }
+}
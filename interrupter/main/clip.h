@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file clip.h
+ * @brief PCM clip bank format and mixer
+ *
+ * Shared by the firmware and the host builder (tools/mkclips). An image is
+ * laid out as:
+ *
+ *   clip_header_t | clip_entry_t index[clip_count] | samples
+ *
+ * Samples are signed 8 bit mono at sample_rate, all fields are little
+ * endian. The mixer reads the samples in place, so a memory-mapped image
+ * plays without any copy.
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+#ifndef CLIP_H
+#define CLIP_H
+
+// clang-format off
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define CLIP_MAGIC 0x31504C43 // "CLP1"
+#define CLIP_VERSION 1
+#define CLIP_SAMPLE_MAX 2047 // Mixer output, signed 12 bits
+#define CLIP_GAIN_UNITY 128
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t clip_count;
+    uint32_t sample_rate;
+    uint32_t index_offset; // From the start of the image
+    uint32_t data_offset;
+    uint32_t data_size;
+} clip_header_t;
+
+typedef struct
+{
+    uint32_t offset; // From data_offset
+    uint32_t length; // Samples
+} clip_entry_t;
+
+typedef struct
+{
+    const int8_t *pos; // NULL when the voice is free
+    const int8_t *end;
+    uint16_t gain;     // CLIP_GAIN_UNITY is unity
+    uint32_t age;
+} clip_voice_t;
+
+_Static_assert(sizeof(clip_header_t) == 24, "clip_header_t layout");
+_Static_assert(sizeof(clip_entry_t) == 8, "clip_entry_t layout");
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+const clip_header_t *clip_open(const uint8_t *data, size_t size);
+bool clip_get(const clip_header_t *hdr, uint16_t index, const int8_t **samples,
+              uint32_t *length);
+
+void clip_voice_start(clip_voice_t *voices, int count, const int8_t *samples,
+                      uint32_t length, uint16_t gain);
+void clip_mix(clip_voice_t *voices, int count, int16_t *out, int n);
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
+
+#endif /* !CLIP_H */
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file clock.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "clock.h"
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define PHASE_GAIN_SHIFT 2  // Kp = 1/4
+#define PERIOD_GAIN_SHIFT 6 // Ki = 1/64
+#define ERROR_AVG_SHIFT 3
+
+// 20..300 BPM
+#define PERIOD_MIN_Q8 ((60000000LL << CLOCK_SHIFT) / (300 * CLOCK_PPQN))
+#define PERIOD_MAX_Q8 ((60000000LL << CLOCK_SHIFT) / (20 * CLOCK_PPQN))
+
+// Locked once the filtered error stays under 1/32 of a period
+#define LOCK_TICKS 24
+#define LOCK_ERROR_SHIFT 5
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static void clock_pll_acquire(clock_pll_t *pll, int64_t time_q8,
+                              int64_t period_q8)
+{
+    pll->last_q8 = time_q8;
+    pll->ticks = 1;
+    pll->locked = false;
+    pll->error_q8 = 0;
+
+    if (period_q8 >= PERIOD_MIN_Q8 && period_q8 <= PERIOD_MAX_Q8)
+    {
+        pll->period_q8 = (int32_t)period_q8;
+        pll->ticks = 2;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+void clock_pll_reset(clock_pll_t *pll) { memset(pll, 0, sizeof(*pll)); }
+
+void clock_pll_tick(clock_pll_t *pll, int64_t time_us)
+{
+    int64_t t = time_us << CLOCK_SHIFT;
+
+    // First tick, or no usable period yet: measure one
+    if (pll->ticks < 2)
+    {
+        if (pll->ticks == 0)
+            clock_pll_acquire(pll, t, 0);
+        else
+            clock_pll_acquire(pll, t, t - pll->last_q8);
+        return;
+    }
+
+    int64_t predicted = pll->last_q8 + pll->period_q8;
+    int64_t error = t - predicted;
+
+    if (error > pll->period_q8 / 2 || error < -pll->period_q8 / 2)
+    {
+        clock_pll_acquire(pll, t, t - pll->last_q8);
+        return;
+    }
+
+    pll->last_q8 = predicted + (error >> PHASE_GAIN_SHIFT);
+    int64_t period = pll->period_q8 + (error >> PERIOD_GAIN_SHIFT);
+    if (period < PERIOD_MIN_Q8) period = PERIOD_MIN_Q8;
+    if (period > PERIOD_MAX_Q8) period = PERIOD_MAX_Q8;
+    pll->period_q8 = (int32_t)period;
+
+    int32_t abs_error = (int32_t)(error < 0 ? -error : error);
+    pll->error_q8 += (abs_error - pll->error_q8) >> ERROR_AVG_SHIFT;
+
+    if (pll->ticks < UINT32_MAX) pll->ticks++;
+    bool settled = pll->error_q8 < (pll->period_q8 >> LOCK_ERROR_SHIFT);
+    pll->locked = pll->ticks > LOCK_TICKS && settled;
+}
+
+int64_t clock_pll_predict(const clock_pll_t *pll, uint32_t ticks_ahead)
+{
+    return (pll->last_q8 + (int64_t)pll->period_q8 * ticks_ahead) >>
+           CLOCK_SHIFT;
+}
+
+uint32_t clock_pll_bpm_x100(const clock_pll_t *pll)
+{
+    if (pll->period_q8 == 0) return 0;
+    return (uint32_t)((6000000000LL << CLOCK_SHIFT) /
+                      ((int64_t)pll->period_q8 * CLOCK_PPQN));
+}
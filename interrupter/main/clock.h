@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file clock.h
+ * @brief MIDI clock tempo estimator
+ *
+ * Second order phase-locked loop on the arrival times of 0xF8 clocks
+ * (24 per quarter note). Each tick compares the arrival with the predicted
+ * time and corrects the phase by 1/4 and the period by 1/64 of the error,
+ * which is close to critical damping: the estimate settles in about 30
+ * ticks and USB arrival jitter is averaged out of the period. Arrivals off
+ * by more than half a period (dropped clocks, tempo jumps) restart the
+ * acquisition. Fixed point only, constant work per tick.
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+#ifndef CLOCK_H
+#define CLOCK_H
+
+// clang-format off
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include <stdbool.h>
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define CLOCK_PPQN 24
+#define CLOCK_SHIFT 8 // Times and period are Q8 microseconds
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+typedef struct
+{
+    int64_t last_q8;   // Locked time of the last tick
+    int32_t period_q8; // Estimated time between ticks
+    int32_t error_q8;  // Filtered absolute phase error
+    uint32_t ticks;    // Ticks since the last (re)acquisition
+    bool locked;
+} clock_pll_t;
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+void clock_pll_reset(clock_pll_t *pll);
+void clock_pll_tick(clock_pll_t *pll, int64_t time_us);
+
+int64_t clock_pll_predict(const clock_pll_t *pll, uint32_t ticks_ahead);
+uint32_t clock_pll_bpm_x100(const clock_pll_t *pll);
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
+
+#endif /* !CLOCK_H */
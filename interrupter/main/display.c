@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file display.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "display.h"
+#include "esp_cpu.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "tasks.h"
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define TAG "display"
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+typedef struct
+{
+    uint8_t x0; // First dirty column, above x1 when the page is clean
+    uint8_t x1; // Last dirty column
+} span_t;
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static const span_t clean = {UINT8_MAX, 0};
+
+// Panel RAM as LVGL rendered it, and as it was last queued to the panel
+static uint8_t frame[DISPLAY_PAGES][DISPLAY_H_RES];
+static uint8_t sent[DISPLAY_PAGES][DISPLAY_H_RES];
+static span_t dirty[DISPLAY_PAGES];
+
+static display_stats_t stats = {0};
+
+// LVGL draws packed pages through set_px_cb. The buffer is sized in
+// lv_color_t for LVGL, which only fills one eighth of it: a frame wide
+// area is rendered one page at a time.
+static uint8_t draw_pixels[DISPLAY_H_RES * DISPLAY_PAGES];
+static lv_disp_draw_buf_t draw_buf;
+static lv_disp_drv_t disp_drv;
+
+static esp_lcd_panel_handle_t panel = NULL;
+static SemaphoreHandle_t lock = NULL;
+static TaskHandle_t flush_task_handle = NULL;
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static void display_mark(int page, int x0, int x1)
+{
+    // Narrow the area down to the columns that differ from the panel
+    while (x0 <= x1 && frame[page][x0] == sent[page][x0]) x0++;
+    while (x1 >= x0 && frame[page][x1] == sent[page][x1]) x1--;
+    if (x0 > x1) return;
+
+    span_t *span = &dirty[page];
+    if (x0 < span->x0) span->x0 = x0;
+    if (x1 > span->x1) span->x1 = x1;
+}
+
+// Areas start and end on page boundaries so set_px_cb owns whole bytes
+static void display_rounder_cb(lv_disp_drv_t *drv, lv_area_t *area)
+{
+    area->y1 &= ~7;
+    area->y2 |= 7;
+}
+
+// Pixels go straight to SSD1306 page format, 8 rows per byte
+static void display_set_px_cb(lv_disp_drv_t *drv, uint8_t *buf,
+                              lv_coord_t buf_w, lv_coord_t x, lv_coord_t y,
+                              lv_color_t color, lv_opa_t opa)
+{
+    if (opa < LV_OPA_50) return; // Same threshold as 1 bit blending
+
+    uint8_t *byte = &buf[buf_w * (y >> 3) + x];
+    if (color.full)
+        *byte |= 1 << (y & 7);
+    else
+        *byte &= ~(1 << (y & 7));
+}
+
+static void display_flush_cb(lv_disp_drv_t *drv, const lv_area_t *area,
+                             lv_color_t *color_p)
+{
+    uint32_t start = esp_cpu_get_cycle_count();
+    const uint8_t *src = (const uint8_t *)color_p;
+    int width = area->x2 - area->x1 + 1;
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    for (int page = area->y1 >> 3; page <= area->y2 >> 3; page++)
+    {
+        memcpy(&frame[page][area->x1], src, width);
+        src += width;
+        display_mark(page, area->x1, area->x2);
+    }
+    stats.flush_cycles += esp_cpu_get_cycle_count() - start;
+    xSemaphoreGive(lock);
+
+    // The pixels are copied, LVGL can render the next area right away
+    lv_disp_flush_ready(drv);
+    if (lv_disp_flush_is_last(drv)) xTaskNotifyGive(flush_task_handle);
+}
+
+static void display_flush_task(void *arg)
+{
+    static uint8_t tx[DISPLAY_H_RES];
+
+    while (1)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        int64_t start = esp_timer_get_time();
+        uint32_t bytes = 0;
+
+        for (int page = 0; page < DISPLAY_PAGES; page++)
+        {
+            // Take the span and mark it sent before the transfer, flushes
+            // made meanwhile are compared against the new content
+            xSemaphoreTake(lock, portMAX_DELAY);
+            span_t span = dirty[page];
+            int len = span.x1 - span.x0 + 1;
+            if (len > 0)
+            {
+                memcpy(tx, &frame[page][span.x0], len);
+                memcpy(&sent[page][span.x0], tx, len);
+                dirty[page] = clean;
+            }
+            xSemaphoreGive(lock);
+
+            if (len <= 0) continue;
+            esp_lcd_panel_draw_bitmap(panel, span.x0, page * 8, span.x1 + 1,
+                                      page * 8 + 8, tx);
+            bytes += len;
+        }
+
+        if (bytes == 0) continue;
+
+        uint32_t us = esp_timer_get_time() - start;
+        xSemaphoreTake(lock, portMAX_DELAY);
+        stats.flushes++;
+        stats.bytes = bytes;
+        stats.last_us = us;
+        if (us > stats.max_us) stats.max_us = us;
+        stats.total_us += us;
+        xSemaphoreGive(lock);
+
+        ESP_LOGD(TAG, "%lu bytes in %lu us", bytes, us);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+lv_disp_t *display_init(esp_lcd_panel_handle_t panel_handle)
+{
+    panel = panel_handle;
+    lock = xSemaphoreCreateMutex();
+
+    // Unknown panel content, the first update sends the whole frame
+    for (int page = 0; page < DISPLAY_PAGES; page++)
+        dirty[page] = (span_t){0, DISPLAY_H_RES - 1};
+
+    flush_task_handle = task_start(TASK_FLUSH, display_flush_task, NULL);
+
+    lv_disp_draw_buf_init(&draw_buf, draw_pixels, NULL,
+                          sizeof(draw_pixels) / sizeof(lv_color_t));
+    lv_disp_drv_init(&disp_drv);
+    disp_drv.hor_res = DISPLAY_H_RES;
+    disp_drv.ver_res = DISPLAY_V_RES;
+    disp_drv.flush_cb = display_flush_cb;
+    disp_drv.rounder_cb = display_rounder_cb;
+    disp_drv.set_px_cb = display_set_px_cb;
+    disp_drv.draw_buf = &draw_buf;
+
+    ESP_LOGI(TAG, "%dx%d, %d pages, %d bytes of buffers", DISPLAY_H_RES,
+             DISPLAY_V_RES, DISPLAY_PAGES,
+             (int)(sizeof(draw_pixels) + sizeof(frame) + sizeof(sent)));
+
+    return lv_disp_drv_register(&disp_drv);
+}
+
+void display_get_stats(display_stats_t *out)
+{
+    // Zero until the screen is up
+    if (lock == NULL)
+    {
+        memset(out, 0, sizeof(*out));
+        return;
+    }
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    *out = stats;
+    xSemaphoreGive(lock);
+}
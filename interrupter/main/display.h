@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file display.h
+ * @brief LVGL display driver for the SSD1306 with dirty page flushing
+ *
+ * LVGL renders at 1 bit per pixel straight into SSD1306 page format (8
+ * rows per byte) and the flush callback copies whole pages into a shadow of
+ * the panel RAM. It compares them with what was last queued to the panel
+ * and only marks the columns that changed, per page. It returns at once: a
+ * low priority task sends the dirty spans over I2C, so the UI never waits on
+ * the bus. Flush time and bytes on the bus are measured for each update.
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+#ifndef DISPLAY_H
+#define DISPLAY_H
+
+// clang-format off
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "esp_lcd_panel_ops.h"
+#include "lvgl.h"
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define DISPLAY_H_RES 128
+#define DISPLAY_V_RES 64
+#define DISPLAY_PAGES (DISPLAY_V_RES / 8)
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t flushes;      // Updates sent to the panel
+    uint32_t bytes;        // Pixel bytes of the last update
+    uint32_t last_us;      // Bus time of the last update
+    uint32_t max_us;       // Worst update
+    uint64_t total_us;     // Bus time since boot
+    uint32_t flush_cycles; // CPU time in the LVGL flush callback since boot
+} display_stats_t;
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+// Call after lv_init, from the task that will own LVGL
+lv_disp_t *display_init(esp_lcd_panel_handle_t panel);
+
+void display_get_stats(display_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
+
+#endif /* !DISPLAY_H */
@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file envelope.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "envelope.h"
+#include <math.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define ONE_Q30 (1 << 30)
+
+// Exponential segments aim past their end point so they get there in finite
+// time, like the RC curve of an analog envelope
+#define ATTACK_OVERSHOOT (ONE_Q30 / 3)
+#define RELEASE_FLOOR (ONE_Q30 >> 10)
+#define DECAY_EPSILON (ONE_Q30 >> 12)
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static int32_t env_linear_step(uint32_t ticks, int32_t span)
+{
+    if (ticks == 0) return span > 0 ? span : 1;
+    int32_t step = (int32_t)(span / (int32_t)ticks);
+    return step > 0 ? step : 1;
+}
+
+static int32_t env_exp_coef(uint32_t ticks, double time_constants)
+{
+    // Pick the time constant so that the segment ends after ticks
+    if (ticks == 0) return 32768;
+    double tau = ticks / time_constants;
+    int32_t coef = (int32_t)lround(32768.0 * (1.0 - exp(-1.0 / tau)));
+    return coef > 0 ? coef : 1;
+}
+
+static inline int32_t env_approach(int32_t level, int32_t target, int32_t coef)
+{
+    return level + (int32_t)(((int64_t)(target - level) * coef) >> 15);
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+void env_config(env_config_t *cfg, const env_params_t *params,
+                uint32_t control_rate_hz)
+{
+    uint32_t attack = params->attack_ms * control_rate_hz / 1000;
+    uint32_t decay = params->decay_ms * control_rate_hz / 1000;
+    uint32_t release = params->release_ms * control_rate_hz / 1000;
+
+    cfg->shape = params->shape;
+    cfg->sustain = (int32_t)params->sustain << 15;
+
+    if (cfg->shape == ENV_SHAPE_LINEAR)
+    {
+        cfg->attack = env_linear_step(attack, ONE_Q30);
+        cfg->decay = env_linear_step(decay, ONE_Q30 - cfg->sustain);
+        cfg->release = env_linear_step(release, ONE_Q30);
+    }
+    else
+    {
+        // ln(4/3 / 1/3), ln(2^12), ln(2^10): see the end conditions
+        cfg->attack = env_exp_coef(attack, 1.386);
+        cfg->decay = env_exp_coef(decay, 8.318);
+        cfg->release = env_exp_coef(release, 6.931);
+    }
+}
+
+void env_gate_on(envelope_t *env)
+{
+    // Restart from the current level, no click on retrigger
+    env->stage = ENV_ATTACK;
+}
+
+void env_gate_off(envelope_t *env)
+{
+    if (env->stage != ENV_IDLE) env->stage = ENV_RELEASE;
+}
+
+void env_reset(envelope_t *env)
+{
+    env->stage = ENV_IDLE;
+    env->level = 0;
+}
+
+uint16_t env_step(envelope_t *env, const env_config_t *cfg)
+{
+    bool linear = cfg->shape == ENV_SHAPE_LINEAR;
+    int32_t level = env->level;
+
+    switch (env->stage)
+    {
+    case ENV_ATTACK:
+        level = linear ? level + cfg->attack
+                       : env_approach(level, ONE_Q30 + ATTACK_OVERSHOOT,
+                                      cfg->attack);
+        if (level >= ONE_Q30)
+        {
+            level = ONE_Q30 - 1;
+            env->stage = ENV_DECAY;
+        }
+        break;
+    case ENV_DECAY:
+        level = linear ? level - cfg->decay
+                       : env_approach(level, cfg->sustain, cfg->decay);
+        if (level <= cfg->sustain + (linear ? 0 : DECAY_EPSILON))
+        {
+            level = cfg->sustain;
+            env->stage = ENV_SUSTAIN;
+        }
+        break;
+    case ENV_SUSTAIN:
+        level = cfg->sustain;
+        break;
+    case ENV_RELEASE:
+        level = linear ? level - cfg->release
+                       : env_approach(level, 0, cfg->release);
+        if (level <= (linear ? 0 : RELEASE_FLOOR))
+        {
+            level = 0;
+            env->stage = ENV_IDLE;
+        }
+        break;
+    case ENV_IDLE:
+    default:
+        level = 0;
+        break;
+    }
+
+    env->level = level;
+    return env_level(env);
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file envelope.h
+ * @brief Incremental Q15 ADSR envelopes
+ *
+ * env_config() turns times in ms into per-tick increments once, when a
+ * patch is selected. env_step() then costs one add (linear) or one
+ * multiply-add (exponential) per voice and control tick.
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+#ifndef ENVELOPE_H
+#define ENVELOPE_H
+
+// clang-format off
+#ifdef __cplusplus
+extern "C" 
+{
+#endif
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include <stdbool.h>
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define ENV_LEVEL_MAX 32767 // Q15 full scale
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+typedef enum
+{
+    ENV_SHAPE_LINEAR,
+    ENV_SHAPE_EXPONENTIAL,
+} env_shape_t;
+
+typedef enum
+{
+    ENV_IDLE,
+    ENV_ATTACK,
+    ENV_DECAY,
+    ENV_SUSTAIN,
+    ENV_RELEASE,
+} env_stage_t;
+
+typedef struct
+{
+    uint16_t attack_ms;
+    uint16_t decay_ms;
+    uint16_t sustain; // Q15
+    uint16_t release_ms;
+    env_shape_t shape;
+} env_params_t;
+
+typedef struct
+{
+    env_shape_t shape;
+    int32_t sustain;  // Q30
+    int32_t attack;   // Linear: Q30 step, exponential: Q15 coefficient
+    int32_t decay;
+    int32_t release;
+} env_config_t;
+
+typedef struct
+{
+    env_stage_t stage;
+    int32_t level; // Q30, the upper 15 bits are the output
+} envelope_t;
+
+// -----------------------------------------------------------------------------
+// Inline Function Definitions
+// -----------------------------------------------------------------------------
+static inline bool env_is_active(const envelope_t *env)
+{
+    return env->stage != ENV_IDLE;
+}
+
+static inline uint16_t env_level(const envelope_t *env)
+{
+    return (uint16_t)(env->level >> 15);
+}
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+void env_config(env_config_t *cfg, const env_params_t *params,
+                uint32_t control_rate_hz);
+
+void env_gate_on(envelope_t *env);
+void env_gate_off(envelope_t *env);
+void env_reset(envelope_t *env);
+uint16_t env_step(envelope_t *env, const env_config_t *cfg);
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
+
+#endif /* !ENVELOPE_H */
@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file knob.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "knob.h"
+#include "button_gpio.h"
+#include "driver/gpio.h"
+#include "driver/pulse_cnt.h"
+#include "esp_err.h"
+#include "esp_timer.h"
+#include "iot_button.h"
+#include "sdkconfig.h"
+#include <stdlib.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define PIN_RE_A CONFIG_INTERRUPT_PIN_RE_A
+#define PIN_RE_B CONFIG_INTERRUPT_PIN_RE_B
+#define PIN_RE_SWT CONFIG_INTERRUPT_PIN_RE_SWT
+
+#define EDGES_PER_DETENT CONFIG_INTERRUPT_RE_EDGES_PER_DETENT
+
+// Hardware count wraps here, accumulated in software past it
+#define COUNT_LIMIT 1000
+
+// Rejects electrical glitches only, a detent at full speed is much longer.
+// Millisecond contact bounce is absorbed by the quadrature count, each
+// bounce counts up then back down.
+#define GLITCH_NS 1000
+
+// A rate from before a pause this long is stale
+#define IDLE_US 200000
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static pcnt_unit_handle_t unit = NULL;
+static QueueHandle_t event_queue = NULL;
+static button_handle_t switch_btn = NULL;
+
+// Edges already turned into detents, the remainder waits for the next ones
+static int taken = 0;
+static int64_t last_us = 0;
+static int32_t last_dir = 0;
+static uint16_t smoothed = 0;
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+// Runs in the button timer task
+static void knob_switch_cb(void *arg, void *usr_data)
+{
+    knob_event_t e = (knob_event_t)(intptr_t)usr_data;
+    xQueueSend(event_queue, &e, 0);
+}
+
+static void knob_channel(int edge_pin, int level_pin,
+                         pcnt_channel_edge_action_t rising,
+                         pcnt_channel_edge_action_t falling)
+{
+    pcnt_chan_config_t chan_config = {
+        .edge_gpio_num = edge_pin,
+        .level_gpio_num = level_pin,
+    };
+    pcnt_channel_handle_t chan = NULL;
+    ESP_ERROR_CHECK(pcnt_new_channel(unit, &chan_config, &chan));
+    // Direction flips with the level of the other pin
+    ESP_ERROR_CHECK(pcnt_channel_set_edge_action(chan, rising, falling));
+    ESP_ERROR_CHECK(pcnt_channel_set_level_action(
+        chan, PCNT_CHANNEL_LEVEL_ACTION_KEEP,
+        PCNT_CHANNEL_LEVEL_ACTION_INVERSE));
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+void knob_init(QueueHandle_t events)
+{
+    event_queue = events;
+
+    pcnt_unit_config_t unit_config = {
+        .low_limit = -COUNT_LIMIT,
+        .high_limit = COUNT_LIMIT,
+        .flags.accum_count = true,
+    };
+    ESP_ERROR_CHECK(pcnt_new_unit(&unit_config, &unit));
+
+    pcnt_glitch_filter_config_t filter_config = {.max_glitch_ns = GLITCH_NS};
+    ESP_ERROR_CHECK(pcnt_unit_set_glitch_filter(unit, &filter_config));
+
+    // Every edge of both pins, 4 counts per quadrature cycle
+    knob_channel(PIN_RE_A, PIN_RE_B, PCNT_CHANNEL_EDGE_ACTION_DECREASE,
+                 PCNT_CHANNEL_EDGE_ACTION_INCREASE);
+    knob_channel(PIN_RE_B, PIN_RE_A, PCNT_CHANNEL_EDGE_ACTION_INCREASE,
+                 PCNT_CHANNEL_EDGE_ACTION_DECREASE);
+    ESP_ERROR_CHECK(gpio_set_pull_mode(PIN_RE_A, GPIO_PULLUP_ONLY));
+    ESP_ERROR_CHECK(gpio_set_pull_mode(PIN_RE_B, GPIO_PULLUP_ONLY));
+
+    // Accumulation happens on the limit watch points
+    ESP_ERROR_CHECK(pcnt_unit_add_watch_point(unit, -COUNT_LIMIT));
+    ESP_ERROR_CHECK(pcnt_unit_add_watch_point(unit, COUNT_LIMIT));
+    ESP_ERROR_CHECK(pcnt_unit_enable(unit));
+    ESP_ERROR_CHECK(pcnt_unit_clear_count(unit));
+    ESP_ERROR_CHECK(pcnt_unit_start(unit));
+
+    button_config_t btn_cfg = {0};
+    button_gpio_config_t gpio_cfg = {
+        .gpio_num = PIN_RE_SWT,
+        .active_level = 0,
+    };
+    ESP_ERROR_CHECK(iot_button_new_gpio_device(&btn_cfg, &gpio_cfg,
+                                               &switch_btn));
+    iot_button_register_cb(switch_btn, BUTTON_SINGLE_CLICK, NULL,
+                           knob_switch_cb, (void *)(intptr_t)KNOB_CLICKED);
+    iot_button_register_cb(switch_btn, BUTTON_LONG_PRESS_START, NULL,
+                           knob_switch_cb,
+                           (void *)(intptr_t)KNOB_LONG_PRESSED);
+
+    last_us = esp_timer_get_time();
+}
+
+int32_t knob_take(uint16_t *rate)
+{
+    int count = 0;
+    pcnt_unit_get_count(unit, &count);
+
+    int32_t detents = (count - taken) / EDGES_PER_DETENT;
+    taken += detents * EDGES_PER_DETENT;
+
+    int64_t now = esp_timer_get_time();
+    if (detents == 0)
+    {
+        if (now - last_us > IDLE_US) smoothed = 0;
+        *rate = smoothed;
+        return 0;
+    }
+
+    // Over the time since the previous detents, slow turns read slow
+    uint32_t elapsed_us = now - last_us;
+    if (elapsed_us == 0) elapsed_us = 1;
+    uint32_t instant = (uint64_t)abs(detents) * 1000000 / elapsed_us;
+    if (instant > UINT16_MAX) instant = UINT16_MAX;
+
+    // Reversing starts over, without carrying speed the other way
+    int32_t dir = detents > 0 ? 1 : -1;
+    if (dir != last_dir || now - last_us > IDLE_US)
+        smoothed = instant;
+    else
+        smoothed = (smoothed + instant) / 2;
+
+    last_dir = dir;
+    last_us = now;
+    *rate = smoothed;
+    return detents;
+}
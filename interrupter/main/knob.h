@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file knob.h
+ * @brief Rotary encoder of the menu, decoded by the pulse counter
+ *
+ * Both encoder pins drive a PCNT unit in full quadrature, behind its glitch
+ * filter: turning costs no CPU and no step is lost however fast, the count
+ * is read when the menu asks for it. Each read returns the detents turned
+ * since the previous one along with the turning rate, for acceleration.
+ * The push switch goes through the button component and posts its clicks
+ * and long presses to the queue given at init.
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+#ifndef KNOB_H
+#define KNOB_H
+
+// clang-format off
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+typedef enum
+{
+    KNOB_CLICKED,
+    KNOB_LONG_PRESSED,
+} knob_event_t;
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+// Switch events are posted to events, a queue of knob_event_t
+void knob_init(QueueHandle_t events);
+
+// Detents since the last call, clockwise positive, and the smoothed rate in
+// detents per second
+int32_t knob_take(uint16_t *rate);
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
+
+#endif /* !KNOB_H */
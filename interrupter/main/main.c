@@ -4,16 +4,37 @@
  * Distributed under terms of the MIT license.
  */
 
+#include "audio.h"
+#include "bench.h"
+#include "boot.h"
 #include "button_gpio.h"
+#include "display.h"
+#include "esp_app_desc.h"
 #include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #include "iot_button.h"
 #include "menu.h"
+#include "midi.h"
+#include "midi_uart.h"
+#include "nvs_flash.h"
+#include "param.h"
+#include "patch.h"
+#include "player.h"
 #include "pwm.h"
+#include "recorder.h"
+#include "seq.h"
+#include "show.h"
+#include "synth.h"
+#include "tasks.h"
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdio.h>
 
 #define PIN_TRIGGER CONFIG_INTERRUPT_PIN_TRIGGER
 #define PIN_JACK_SW CONFIG_INTERRUPT_PIN_JACK_SW
+#define CLIP_BASE_NOTE CONFIG_INTERRUPT_CLIP_BASE_NOTE
+#define CPU_MHZ CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ
 
 #define TAG "interrupter"
 
@@ -28,6 +49,8 @@ static void button_down_cb(void *arg, void *usr_data)
     {
         ESP_LOGI(TAG, "Trigger button pressed → Armed");
         pwm_arm();
+        if (pwm_get_mode() == PWM_CLIPS)
+            audio_clip_trigger(audio_clip_get_selected(), 127);
     }
     else if (btn == jack_btn)
     {
@@ -52,11 +75,172 @@ static void button_up_cb(void *arg, void *usr_data)
     }
 }
 
-void app_main(void)
+static void midi_event_cb(midi_event_data_t *event)
+{
+    switch (event->type)
+    {
+    case MIDI_EVENT_DEV_CONNECTED:
+        ESP_LOGI(TAG, "MIDI device connected → MIDI mode");
+        if (pwm_get_mode() != PWM_MIDI && pwm_get_mode() != PWM_CLIPS)
+        {
+            player_stop();
+            show_stop();
+            pwm_set_mode(PWM_MIDI);
+        }
+        break;
+    case MIDI_EVENT_MSG_RECEIVED:
+        // Clock and transport drive the sequencer, not the synth
+        if (event->msg.type >= MIDI_MSG_CLOCK)
+        {
+#if CONFIG_INTERRUPT_CLOCK_FOLLOW
+            bool start = event->msg.type == MIDI_MSG_START ||
+                         event->msg.type == MIDI_MSG_CONTINUE;
+            if (start && pwm_get_mode() != PWM_MIDI)
+            {
+                ESP_LOGI(TAG, "MIDI start → MIDI mode");
+                player_stop();
+                show_stop();
+                pwm_set_mode(PWM_MIDI);
+            }
+            seq_clock(&event->msg, event->time_us);
+#endif
+            break;
+        }
+        // DIN input has no connection event, take over on first message
+        if (event->source == MIDI_SOURCE_UART && pwm_get_mode() == PWM_MANUAL)
+        {
+            ESP_LOGI(TAG, "Serial MIDI input → MIDI mode");
+            pwm_set_mode(PWM_MIDI);
+        }
+        // Live input only, the loop plays back through here as well
+        if (event->source == MIDI_SOURCE_USB ||
+            event->source == MIDI_SOURCE_UART)
+            recorder_append(&event->msg, event->time_us);
+        // Notes trigger the clips instead of the synth in clip mode
+        if (pwm_get_mode() == PWM_CLIPS)
+        {
+            if (event->msg.type == MIDI_MSG_NOTE && event->msg.velocity > 0 &&
+                event->msg.note >= CLIP_BASE_NOTE)
+                audio_clip_trigger(event->msg.note - CLIP_BASE_NOTE,
+                                   event->msg.velocity);
+            break;
+        }
+        // Held notes feed the arpeggiator while the sequencer runs
+        if (event->msg.type == MIDI_MSG_NOTE && seq_is_running() &&
+            seq_get_arp_mode() != SEQ_ARP_OFF)
+        {
+            seq_arp_note(&event->msg);
+            break;
+        }
+        synth_post(&event->msg);
+        break;
+    case MIDI_EVENT_DEV_DISCONNECTED:
+        // Keep playing while another device, the sequencer, the loop or the
+        // clips are active
+        if (midi_is_connected() || seq_is_running() ||
+            recorder_get_state() != REC_STOPPED ||
+            pwm_get_mode() == PWM_CLIPS)
+            break;
+        ESP_LOGI(TAG, "MIDI device disconnected → Manual mode");
+        pwm_set_mode(PWM_MANUAL);
+        break;
+    }
+}
+
+// Screen and knob, brought up while the rest of the boot goes on
+static void ui_init_task(void *arg)
 {
     menu_init();
+    boot_mark(BOOT_UI);
+    vTaskDelete(NULL);
+}
+
+// USB host and serial MIDI, the slowest to come up
+static void usb_init_task(void *arg)
+{
+    midi_set_event_callback(midi_event_cb);
+    midi_init();
+#if CONFIG_INTERRUPT_MIDI_UART
+    midi_uart_init();
+#endif
+    boot_mark(BOOT_USB);
+    vTaskDelete(NULL);
+}
+
+// Peripheral counters, logged with the task latencies
+static void stats_report(void)
+{
+    display_stats_t disp;
+    display_get_stats(&disp);
+    if (disp.flushes > 0)
+        ESP_LOGI(TAG,
+                 "display: %lu updates, %llu us on the bus on average, "
+                 "worst %lu us, %llu us of CPU each",
+                 disp.flushes, disp.total_us / disp.flushes, disp.max_us,
+                 (uint64_t)disp.flush_cycles / CPU_MHZ / disp.flushes);
+
+    for (uint8_t slot = 0; slot < MIDI_MAX_DEVICES; slot++)
+    {
+        midi_device_stats_t dev;
+        if (!midi_get_device_stats(slot, &dev)) continue;
+        ESP_LOGI(TAG,
+                 "%s at %u: %lu messages, %lu/s, peak %lu/s, %lu transfer "
+                 "errors",
+                 dev.name, dev.address, dev.messages, dev.rate_hz,
+                 dev.peak_rate_hz, dev.errors);
+    }
+
+#if CONFIG_INTERRUPT_MIDI_UART
+    // Over the report period, a count racing the reset may be lost
+    midi_uart_stats_t uart;
+    midi_uart_get_stats(&uart);
+    midi_uart_reset_stats();
+    if (uart.bytes > 0)
+        ESP_LOGI(TAG,
+                 "serial MIDI: %lu bytes, %lu messages, %lu overruns, "
+                 "%llu us to post on average, worst %lu us",
+                 uart.bytes, uart.messages, uart.overruns,
+                 uart.messages ? uart.latency_us_total / uart.messages : 0,
+                 uart.latency_us_max);
+#endif
+}
+
+#if CONFIG_INTERRUPT_BENCH
+static void bench_print(const bench_result_t *result, void *ctx)
+{
+    char line[256];
+    bench_format(result, esp_app_get_description()->version, line,
+                 sizeof(line));
+    printf("%s\n", line);
+}
+#endif
+
+void app_main(void)
+{
+#if CONFIG_INTERRUPT_BENCH
+    // Benchmark build, nothing else runs
+    bench_run(NULL, bench_print, NULL);
+    return;
+#endif
+
+    boot_mark(BOOT_MAIN);
+
+    esp_err_t err = nvs_flash_init();
+    if (err == ESP_ERR_NVS_NO_FREE_PAGES ||
+        err == ESP_ERR_NVS_NEW_VERSION_FOUND)
+    {
+        ESP_ERROR_CHECK(nvs_flash_erase());
+        err = nvs_flash_init();
+    }
+    ESP_ERROR_CHECK(err);
+
+    param_init(); // Before the screen shows them
+    boot_mark(BOOT_SETTINGS);
+
+    // Output and trigger first, nothing else is needed to fire
     pwm_init();
     pwm_set_mode(PWM_MANUAL);
+    param_apply_output();
 
     button_config_t btn_cfg = {0};
 
@@ -81,4 +265,38 @@ void app_main(void)
                            (void *)jack_btn);
     iot_button_register_cb(jack_btn, BUTTON_PRESS_UP, NULL, button_up_cb,
                            (void *)jack_btn);
+    boot_mark(BOOT_ARMABLE);
+
+    // Read by the menu and by MIDI input, up before either starts
+    seq_init();
+    ESP_ERROR_CHECK(recorder_init());
+    patch_init();
+
+    // Screen and USB on their cores, while the clips load on this one
+    task_start(TASK_UI_INIT, ui_init_task, NULL);
+    task_start(TASK_USB_INIT, usb_init_task, NULL);
+    audio_clips_init();
+
+    esp_err_t player_err = player_init();
+    esp_err_t show_err = show_init();
+#if CONFIG_INTERRUPT_SHOW_AUTOPLAY
+    if (show_err == ESP_OK && !midi_is_connected())
+    {
+        pwm_set_mode(PWM_MIDI);
+        show_play(0);
+    }
+#else
+    (void)show_err;
+#endif
+#if CONFIG_INTERRUPT_SMF_AUTOPLAY
+    if (player_err == ESP_OK && !midi_is_connected() && !show_is_playing())
+    {
+        pwm_set_mode(PWM_MIDI);
+        player_play(0);
+    }
+#else
+    (void)player_err;
+#endif
+    tasks_monitor_init(stats_report);
+    boot_mark(BOOT_DONE);
 }
@@ -17,19 +17,23 @@
 // Includes
 // -----------------------------------------------------------------------------
 #include "menu.h"
-#include "audio.h"
 #include "driver/i2c.h"
-#include "encoder.h"
 #include "esp_err.h"
 #include "esp_lcd_panel_dev.h"
 #include "esp_lcd_panel_ops.h"
 #include "esp_lcd_panel_ssd1306.h"
 #include "esp_log.h"
-#include "esp_lvgl_port.h"
-#include "lvgl.h"
+#include "knob.h"
+#include "midi.h"
+#include "output.h"
+#include "param.h"
 #include "pwm.h"
 #include "sdkconfig.h"
-#include "ui/ui.h"
+#include "seq.h"
+#include "settings.h"
+#include "tasks.h"
+#include "telemetry.h"
+#include "view.h"
 #include <stdint.h>
 #include <string.h>
 
@@ -38,10 +42,6 @@
 // -----------------------------------------------------------------------------
 #define TAG "menu"
 
-#define PIN_RE_A CONFIG_INTERRUPT_PIN_RE_A
-#define PIN_RE_B CONFIG_INTERRUPT_PIN_RE_B
-#define PIN_RE_SWT CONFIG_INTERRUPT_PIN_RE_SWT
-
 #define PIN_SDA CONFIG_INTERRUPT_PIN_SDA
 #define PIN_SCL CONFIG_INTERRUPT_PIN_SCL
 
@@ -55,121 +55,149 @@
 #define LCD_CMD_BITS 8
 #define LCD_PARAM_BITS 8
 
+#define PARAMS_PER_PAGE VIEW_SLOTS
+
+// Knob rate in detents per second, fine steps below, coarse steps above
+#define ACCEL_SLOW 8
+#define ACCEL_FAST 40
+
 // -----------------------------------------------------------------------------
 // Static Variables
 // -----------------------------------------------------------------------------
-typedef struct
-{
-    char name[4];
-    int16_t value;
-    int16_t min_value;
-    int16_t max_value;
-    uint16_t steps[2];
-    lv_obj_t *val_txt;
-    lv_obj_t *name_txt;
-} range_t;
-
-static range_t pd_range = {
-    .name = "PD", .min_value = 0, .max_value = 100, .steps = {1, 10}};
-
-static range_t prf_range = {
-    .name = "PRF", .min_value = 0, .max_value = 20e3, .steps = {1, 100}};
-
-static range_t *ranges[2] = {
-    &pd_range,
-    &prf_range,
-};
-
-static uint8_t range_count = 2;
-
-static QueueHandle_t re_event_queue;
-static rotary_encoder_t re;
-static range_t *sel_range = NULL;
-static uint8_t sel_range_ind = 0;
-static uint8_t step_ind = 0;
+static QueueHandle_t knob_queue;
+static param_id_t sel_param = 0;
 static bool editing = false;
+static view_screen_t screen = VIEW_MAIN;
+static bool spectrum = false;
+static telemetry_t telemetry;
+static TickType_t telemetry_tick = 0;
 
 static bool trigger_state = false;
 static bool jack_plugged = false;
 
-static lv_disp_t *disp = NULL;
-
 // -----------------------------------------------------------------------------
 // Static Function Definitions
 // -----------------------------------------------------------------------------
-static void menu_task(void *pvParam)
+// Page on screen for the view, loads follow changes made behind the menu
+static void menu_publish(void)
 {
-    while (1)
-    {
-        // Rotary encoder
-        rotary_encoder_event_t e;
-        xQueueReceive(re_event_queue, &e, portMAX_DELAY);
+    view_state_t state;
+    memset(&state, 0, sizeof(state));
+    state.screen = screen;
+    state.spectrum = spectrum;
 
-        switch (e.type)
-        {
-        case RE_ET_BTN_PRESSED:
-            ESP_LOGI(TAG, "Button pressed");
-            break;
-        case RE_ET_BTN_RELEASED:
-            ESP_LOGI(TAG, "Button released");
-            break;
-        case RE_ET_BTN_CLICKED:
-            ESP_LOGI(TAG, "Button clicked");
-            editing = !editing;
-            step_ind = 0;
-            break;
-        case RE_ET_BTN_LONG_PRESSED:
-            ESP_LOGI(TAG, "Looooong pressed button");
-            step_ind = step_ind == 0 ? 1 : 0;
-            break;
-        case RE_ET_CHANGED:
+    // Averaged over a frame, input events in between keep the last figures
+    if (screen == VIEW_TELEMETRY)
+    {
+        TickType_t now = xTaskGetTickCount();
+        if (now - telemetry_tick >= pdMS_TO_TICKS(VIEW_FRAME_MS))
         {
-            int8_t sign = (e.diff > 0 ? 1 : -1);
-            if (editing)
-            {
-                // Range selected, edit it
-                sel_range->value += sel_range->steps[step_ind] * sign;
-                if (sel_range->value < sel_range->min_value)
-                    sel_range->value = sel_range->min_value;
-                else if (sel_range->value > sel_range->max_value)
-                    sel_range->value = sel_range->max_value;
+            telemetry_sample(&telemetry);
+            telemetry_tick = now;
+        }
+        state.telemetry = telemetry;
+    }
 
-                if (pwm_get_mode() == PWM_MANUAL)
-                    pwm_manual_update(prf_range.value, pd_range.value);
-                else if (pwm_get_mode() == PWM_AUDIO)
-                    // TODO: EDIT THIS
-                    audio_set_volume(pd_range.value * 255 / 100);
-                ESP_LOGI(TAG, "Selected: %s, Value: %d", sel_range->name,
-                         sel_range->value);
-            }
-            else
-            {
-                // Navigate between ranges
+    param_id_t first = sel_param - sel_param % PARAMS_PER_PAGE;
+    for (uint8_t slot = 0;
+         slot < PARAMS_PER_PAGE && first + slot < PARAM_COUNT; slot++)
+    {
+        const param_desc_t *desc = param_desc(first + slot);
+        memcpy(state.names[slot], desc->name, sizeof(state.names[slot]));
+        state.values[slot] = param_get(first + slot);
+    }
+    state.selected = sel_param % PARAMS_PER_PAGE;
+    state.mode = pwm_get_mode();
+    state.armed = output_is_armed();
+    state.midi_connected = midi_is_connected();
 
-                lv_label_set_text(sel_range->name_txt, sel_range->name);
+    view_publish(&state);
+}
 
-                sel_range_ind += sign;
-                sel_range_ind = (sel_range_ind + range_count) % range_count;
-                sel_range = ranges[sel_range_ind];
+// Fine steps at rest, ramping up to coarse steps with the knob rate
+static int32_t menu_step(const param_desc_t *desc, uint16_t rate)
+{
+    int32_t slow = desc->steps[0];
+    int32_t fast = desc->steps[1];
 
-                char buf[12];
-                sprintf(buf, ">%s<", sel_range->name);
-                lv_label_set_text(sel_range->name_txt, buf);
+    if (rate <= ACCEL_SLOW) return slow;
+    if (rate >= ACCEL_FAST) return fast;
+    return slow +
+           (fast - slow) * (rate - ACCEL_SLOW) / (ACCEL_FAST - ACCEL_SLOW);
+}
 
-                ESP_LOGI(TAG, "%s, Value: %d", sel_range->name,
-                         sel_range->value);
-            }
-            char val_str[12];
-            sprintf(val_str, "%d", sel_range->value);
-            lv_label_set_text(sel_range->val_txt, val_str);
-            break;
-        }
-        default:
+static void menu_switch(knob_event_t e)
+{
+    switch (e)
+    {
+    case KNOB_CLICKED:
+        ESP_LOGI(TAG, "Button clicked");
+        // The scope toggles between waveform and spectrum
+        if (screen == VIEW_SCOPE)
+        {
+            spectrum = !spectrum;
             break;
         }
+        if (screen != VIEW_MAIN) break;
+        editing = !editing;
+        if (editing) break;
+        // A recalled preset lands before the patterns are persisted
+        param_done(sel_param);
+        param_commit();
+        // Persist the patterns once done editing, nothing when unchanged
+        seq_save();
+        break;
+    case KNOB_LONG_PRESSED:
+        ESP_LOGI(TAG, "Looooong pressed button");
+        screen = (screen + 1) % VIEW_SCREEN_COUNT;
+        break;
+    default:
+        break;
+    }
+}
+
+static void menu_turn(int32_t detents, uint16_t rate)
+{
+    char buf[16];
 
-        // LVGL
-        lv_timer_handler();
+    if (editing)
+    {
+        // Parameter selected, edit it, applied with the next commit
+        const param_desc_t *desc = param_desc(sel_param);
+        int32_t step = menu_step(desc, rate);
+        param_set(sel_param, param_get(sel_param) + step * detents);
+        param_format(sel_param, buf, sizeof(buf));
+        ESP_LOGI(TAG, "Selected: %s, Value: %s", desc->name, buf);
+    }
+    else
+    {
+        // Navigate between parameters, a page at a time on screen
+        int32_t ind = ((int32_t)sel_param + detents) % PARAM_COUNT;
+        sel_param = ind < 0 ? ind + PARAM_COUNT : ind;
+
+        param_format(sel_param, buf, sizeof(buf));
+        ESP_LOGI(TAG, "%s, Value: %s", param_desc(sel_param)->name, buf);
+    }
+}
+
+static void menu_task(void *pvParam)
+{
+    while (1)
+    {
+        menu_publish();
+
+        // Switch events, or a frame to read the knob and refresh the values
+        knob_event_t e;
+        if (xQueueReceive(knob_queue, &e, pdMS_TO_TICKS(VIEW_FRAME_MS)) ==
+            pdTRUE)
+            menu_switch(e);
+
+        uint16_t rate;
+        int32_t detents = knob_take(&rate);
+        // Turning only works on the parameters
+        if (detents && screen == VIEW_MAIN) menu_turn(detents, rate);
+        param_commit();
+        settings_poll();
     }
 }
 
@@ -216,45 +244,14 @@ void menu_init(void)
     ESP_ERROR_CHECK(esp_lcd_panel_disp_on_off(panel_handle, true));
 
     ESP_LOGI(TAG, "Initialize LVGL");
-    const lvgl_port_cfg_t lvgl_cfg = ESP_LVGL_PORT_INIT_CONFIG();
-    lvgl_port_init(&lvgl_cfg);
-
-    const lvgl_port_display_cfg_t disp_cfg = {.io_handle = io_handle,
-                                              .panel_handle = panel_handle,
-                                              .buffer_size =
-                                                  LCD_H_RES * LCD_V_RES,
-                                              .double_buffer = true,
-                                              .hres = LCD_H_RES,
-                                              .vres = LCD_V_RES,
-                                              .monochrome = true,
-                                              .rotation = {
-                                                  .swap_xy = false,
-                                                  .mirror_x = false,
-                                                  .mirror_y = false,
-                                              }};
-    disp = lvgl_port_add_disp(&disp_cfg);
+    view_init(panel_handle);
 
-    /* Rotation of the screen */
-    lv_disp_set_rotation(disp, LV_DISP_ROT_NONE);
-
-    re_event_queue = xQueueCreate(5, sizeof(rotary_encoder_event_t));
-
-    // Setup rotary encoder library
-    ESP_ERROR_CHECK(rotary_encoder_init(re_event_queue));
-    memset(&re, 0, sizeof(rotary_encoder_t));
-    re.pin_a = PIN_RE_A, re.pin_b = PIN_RE_B, re.pin_btn = PIN_RE_SWT,
-    rotary_encoder_add(&re);
+    // Turns are counted by the knob, only its switch goes through the queue
+    knob_queue = xQueueCreate(5, sizeof(knob_event_t));
+    knob_init(knob_queue);
 
     editing = false;
-    step_ind = 0;
-    sel_range_ind = 0;
-    sel_range = ranges[sel_range_ind];
-
-    ui_init();
-    pd_range.val_txt = objects.dc_val_txt;
-    prf_range.val_txt = objects.prf_val_txt;
-    pd_range.name_txt = objects.dc_txt;
-    prf_range.name_txt = objects.prf_txt;
+    sel_param = 0;
 
-    xTaskCreate(menu_task, "menu_task", 4096, NULL, 0, NULL);
+    task_start(TASK_MENU, menu_task, NULL);
 }
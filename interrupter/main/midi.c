@@ -18,8 +18,13 @@
 // -----------------------------------------------------------------------------
 #include "midi.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
+#include "midi_parse.h"
+#include "tasks.h"
+#include "usb/usb_helpers.h"
 #include "usb/usb_host.h"
+#include <stdio.h>
 #include <string.h>
 
 // -----------------------------------------------------------------------------
@@ -30,33 +35,70 @@
 
 // MIDI message are 4byte and can be packed up to a 64bytes USB packet
 #define MIDI_PACKET_SIZE 64
-#define MIDI_EP_ADDR 0x81
-#define MIDI_INTERFACE_NB 1
+#define MIDI_SUBCLASS_STREAMING 0x03
 
-#define HOST_TASK_PRIO 2
-#define CLIENT_TASK_PRIO 1
-#define HOST_TASK_STACK (5 * 1024)
-#define CLIENT_TASK_STACK (5 * 1024)
+// IN transfers kept in flight per device, so the endpoint is polled again
+// while a completed packet is being decoded
+#define MIDI_TRANSFERS CONFIG_INTERRUPT_MIDI_TRANSFERS
+
+// A transfer failing this many times in a row is given up, so a stalled
+// endpoint does not keep the client task busy
+#define MIDI_ERRORS_MAX 16
+
+#define DEV_NAME_LEN 32
+#define RATE_WINDOW_US 1000000
 
 #define TAG "midi"
 
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t actions;
+    uint8_t dev_addr;
+    usb_device_handle_t dev_hdl;
+    bool open;
+
+    uint8_t interface;
+    uint8_t ep_addr;
+    uint16_t ep_mps;
+    usb_transfer_t *transfers[MIDI_TRANSFERS];
+    uint8_t in_flight;
+    uint8_t error_run; // Errors since the last completed transfer
+
+    char name[DEV_NAME_LEN];
+    int8_t channel; // Forced channel, or MIDI_CHANNEL_KEEP
+
+    // Notes held on the device, released if it goes away
+    uint32_t notes_on[16][4];
+
+    uint32_t messages;
+    uint32_t window_count;
+    int64_t window_start_us;
+    uint32_t rate_hz;
+    uint32_t peak_rate_hz;
+    uint32_t errors;
+    int64_t connected_us;
+} midi_device_t;
+
+struct class_driver_control
+{
+    usb_host_client_handle_t client_hdl;
+    midi_device_t devices[MIDI_MAX_DEVICES];
+};
+
 // -----------------------------------------------------------------------------
 // Static Variables
 // -----------------------------------------------------------------------------
-volatile bool transfer_active = false;
+static volatile uint8_t open_count = 0;
+static const char *last_dev_name = NULL;
 
-static midi_event_data_t event_data = {0};
 static void (*midi_event_callback)(midi_event_data_t *event) = NULL;
 
 static TaskHandle_t usb_host_task_hdl, usb_client_task_hdl;
 
-struct class_driver_control
-{
-    uint32_t actions;
-    uint8_t dev_addr;
-    usb_host_client_handle_t client_hdl;
-    usb_device_handle_t dev_hdl;
-};
+static struct class_driver_control class_driver_obj = {0};
 
 // -----------------------------------------------------------------------------
 // Static Function Declarations
@@ -68,131 +110,76 @@ static void midi_in_cb(usb_transfer_t *transfer);
 static void client_event_cb(const usb_host_client_event_msg_t *event_msg,
                             void *arg);
 
+static void midi_device_open(struct class_driver_control *drv,
+                             midi_device_t *dev);
+static void midi_device_close(struct class_driver_control *drv,
+                              midi_device_t *dev);
+
 // -----------------------------------------------------------------------------
 // Function Definitions
 // -----------------------------------------------------------------------------
 void midi_init(void)
 {
-    BaseType_t task_created;
+    for (int i = 0; i < MIDI_MAX_DEVICES; i++)
+    {
+#if CONFIG_INTERRUPT_MIDI_CHANNEL_PER_DEVICE
+        class_driver_obj.devices[i].channel = i;
+#else
+        class_driver_obj.devices[i].channel = MIDI_CHANNEL_KEEP;
+#endif
+    }
+
     // Create USB host task
-    task_created =
-        xTaskCreatePinnedToCore(usb_host_task, "usb_host", HOST_TASK_STACK,
-                                xTaskGetCurrentTaskHandle(), HOST_TASK_PRIO, &usb_host_task_hdl, 0);
-    assert(task_created == pdPASS);
+    usb_host_task_hdl = task_start(TASK_USB_HOST, usb_host_task,
+                                   xTaskGetCurrentTaskHandle());
 
     ulTaskNotifyTake(false, 1000);
 
     // Create USB client (class driver) task
-    task_created = xTaskCreatePinnedToCore(
-        usb_client_task, "usb_client", CLIENT_TASK_STACK, NULL,
-        CLIENT_TASK_PRIO, &usb_client_task_hdl, 0);
-    assert(task_created == pdPASS);
+    usb_client_task_hdl = task_start(TASK_USB_CLIENT, usb_client_task, NULL);
 }
 
 static void usb_client_task(void *pvParams)
 {
-    // Initialize class driver objects
-    static struct class_driver_control class_driver_obj = {0};
+    struct class_driver_control *drv = &class_driver_obj;
+
     // Register the client
     usb_host_client_config_t client_config = {
         .is_synchronous = false,
-        .max_num_event_msg = 5,
+        .max_num_event_msg = 5 + 2 * MIDI_MAX_DEVICES,
         .async = {
             .client_event_callback = client_event_cb,
-            .callback_arg = &class_driver_obj,
+            .callback_arg = drv,
         }};
-    esp_err_t ret =
-        usb_host_client_register(&client_config, &class_driver_obj.client_hdl);
+    esp_err_t ret = usb_host_client_register(&client_config, &drv->client_hdl);
     ESP_ERROR_CHECK(ret);
 
-    // Allocate a USB transfer
-    usb_transfer_t *transfer;
-    usb_host_transfer_alloc(MIDI_PACKET_SIZE, 0, &transfer);
-    memset(transfer->data_buffer, 0xAA, MIDI_PACKET_SIZE);
-    transfer->num_bytes = MIDI_PACKET_SIZE;
-    transfer->bEndpointAddress = MIDI_EP_ADDR;
-    transfer->callback = midi_in_cb;
-    transfer->context = (void *)&class_driver_obj;
-
     while (1)
     {
-        usb_host_client_handle_events(class_driver_obj.client_hdl,
-                                      portMAX_DELAY);
-        if (class_driver_obj.actions & ACTION_OPEN_DEV)
+        usb_host_client_handle_events(drv->client_hdl, portMAX_DELAY);
+
+        // Transfer callbacks run from usb_host_client_handle_events() too,
+        // so the device table is only ever touched from this task
+        for (int i = 0; i < MIDI_MAX_DEVICES; i++)
         {
-            ESP_LOGI(TAG, "USB device connected");
-            // Open the device and claim interface 1
-            esp_err_t err = usb_host_device_open(class_driver_obj.client_hdl,
-                                                 class_driver_obj.dev_addr,
-                                                 &class_driver_obj.dev_hdl);
-            err = usb_host_interface_claim(class_driver_obj.client_hdl,
-                                           class_driver_obj.dev_hdl,
-                                           MIDI_INTERFACE_NB, 0);
-            if (err == ESP_OK)
+            midi_device_t *dev = &drv->devices[i];
+
+            if (dev->actions & ACTION_OPEN_DEV)
             {
-                usb_device_info_t dev_info;
-                ESP_ERROR_CHECK(
-                    usb_host_device_info(class_driver_obj.dev_hdl, &dev_info));
-                const usb_str_desc_t *str_desc = dev_info.str_desc_product;
-                char buf[64] = {0};
-                int n = 0;
-                for (int i = 0; i < str_desc->bLength / 2; i++)
-                {
-                    /*
-                    USB String descriptors of UTF-16.
-                    Right now We just skip any character larger than 0xFF to
-                    stay in BMP Basic Latin and Latin-1 Supplement range.
-                    */
-                    if (str_desc->wData[i] > 0xFF)
-                    {
-                        continue;
-                    }
-                    buf[n] = (char)str_desc->wData[i];
-                    n++;
-                }
-                if (n > 64) n = 64;
-                event_data.dev_name = malloc(n + 1);
-                memcpy(event_data.dev_name, buf, n);
-                event_data.dev_name[n] = '\0';
-                ESP_LOGI(TAG, "found MIDI interface on device: %s", buf);
-
-                event_data.type = MIDI_EVENT_DEV_CONNECTED;
-                if (midi_event_callback) midi_event_callback(&event_data);
-
-                transfer->device_handle = class_driver_obj.dev_hdl;
-                transfer_active = true;
-                usb_host_transfer_submit(transfer);
+                dev->actions &= ~ACTION_OPEN_DEV;
+                midi_device_open(drv, dev);
             }
-            else
+            // Wait for the transfers in flight to come back first
+            if ((dev->actions & ACTION_CLOSE_DEV) && dev->in_flight == 0)
             {
-                ESP_LOGI(TAG, "No MIDI endpoint found. Removing device.");
-                class_driver_obj.actions |= ACTION_CLOSE_DEV;
+                dev->actions &= ~ACTION_CLOSE_DEV;
+                midi_device_close(drv, dev);
             }
         }
-        if (class_driver_obj.actions & ACTION_CLOSE_DEV)
-        {
-            transfer_active = false;
-            transfer->device_handle = NULL;
-            vTaskDelay(pdMS_TO_TICKS(100));
-            usb_host_interface_release(class_driver_obj.client_hdl,
-                                       class_driver_obj.dev_hdl,
-                                       MIDI_INTERFACE_NB);
-            usb_host_device_close(class_driver_obj.client_hdl,
-                                  class_driver_obj.dev_hdl);
-
-            ESP_LOGI(TAG, "USB device disconnected");
-            free(event_data.dev_name);
-            event_data.dev_name = NULL;
-            event_data.type = MIDI_EVENT_DEV_DISCONNECTED;
-            if (midi_event_callback) midi_event_callback(&event_data);
-        }
-
-        class_driver_obj.actions = 0;
     }
 
     // Cleanup class driver
-    usb_host_transfer_free(transfer);
-    usb_host_client_deregister(class_driver_obj.client_hdl);
+    usb_host_client_deregister(drv->client_hdl);
 }
 
 static void usb_host_task(void *pvParams)
@@ -231,16 +218,46 @@ static void usb_host_task(void *pvParams)
     vTaskSuspend(NULL);
 }
 
-inline bool midi_is_connected() { return transfer_active; }
+inline bool midi_is_connected() { return open_count > 0; }
 
 const char *midi_get_device_name(void)
 {
-    if (!transfer_active)
+    if (open_count == 0)
     {
         return NULL;
     }
 
-    return event_data.dev_name;
+    return last_dev_name;
+}
+
+bool midi_get_device_stats(uint8_t slot, midi_device_stats_t *stats)
+{
+    if (slot >= MIDI_MAX_DEVICES) return false;
+
+    const midi_device_t *dev = &class_driver_obj.devices[slot];
+    if (!dev->open) return false;
+
+    stats->name = dev->name;
+    stats->address = dev->dev_addr;
+    stats->channel = dev->channel;
+    stats->messages = dev->messages;
+    stats->peak_rate_hz = dev->peak_rate_hz;
+    stats->errors = dev->errors;
+    stats->connected_us = dev->connected_us;
+
+    // The window is only closed on traffic, an idle device reads 0
+    bool stale =
+        esp_timer_get_time() - dev->window_start_us > 2 * RATE_WINDOW_US;
+    stats->rate_hz = stale ? 0 : dev->rate_hz;
+
+    return true;
+}
+
+void midi_set_channel_remap(uint8_t slot, int8_t channel)
+{
+    if (slot >= MIDI_MAX_DEVICES || channel > 15) return;
+    class_driver_obj.devices[slot].channel =
+        channel < 0 ? MIDI_CHANNEL_KEEP : channel;
 }
 
 void midi_set_event_callback(void (*cb)(midi_event_data_t *event))
@@ -248,6 +265,18 @@ void midi_set_event_callback(void (*cb)(midi_event_data_t *event))
     midi_event_callback = cb;
 }
 
+void midi_post(midi_source_t source, const midi_message_t *msg,
+               int64_t time_us)
+{
+    midi_event_data_t event = {
+        .type = MIDI_EVENT_MSG_RECEIVED,
+        .msg = *msg,
+        .source = source,
+        .time_us = time_us,
+    };
+    if (midi_event_callback) midi_event_callback(&event);
+}
+
 void midi_free(void)
 {
     // Uninstall the USB Host Library
@@ -258,20 +287,256 @@ void midi_free(void)
 // -----------------------------------------------------------------------------
 // Static Function Definitions
 // -----------------------------------------------------------------------------
+static void midi_notify(midi_event_t type, midi_device_t *dev)
+{
+    midi_event_data_t event = {
+        .type = type,
+        .source = MIDI_SOURCE_USB,
+        .device = dev - class_driver_obj.devices,
+        .time_us = esp_timer_get_time(),
+        .dev_name = dev->name,
+    };
+    if (midi_event_callback) midi_event_callback(&event);
+}
+
+static void midi_device_post(midi_device_t *dev, midi_message_t *msg,
+                             int64_t now)
+{
+    if (dev->channel != MIDI_CHANNEL_KEEP) msg->channel = dev->channel;
+
+    if (msg->type == MIDI_MSG_NOTE)
+    {
+        uint32_t *word = &dev->notes_on[msg->channel][msg->note >> 5];
+        uint32_t bit = 1UL << (msg->note & 31);
+        if (msg->state)
+            *word |= bit;
+        else
+            *word &= ~bit;
+    }
+
+    dev->messages++;
+    dev->window_count++;
+
+    midi_event_data_t event = {
+        .type = MIDI_EVENT_MSG_RECEIVED,
+        .msg = *msg,
+        .source = MIDI_SOURCE_USB,
+        .device = dev - class_driver_obj.devices,
+        .time_us = now,
+        .dev_name = dev->name,
+    };
+    if (midi_event_callback) midi_event_callback(&event);
+}
+
+// Find the first MIDI streaming interface with a bulk IN endpoint
+static bool midi_find_endpoint(midi_device_t *dev)
+{
+    const usb_config_desc_t *cfg;
+    if (usb_host_get_active_config_descriptor(dev->dev_hdl, &cfg) != ESP_OK)
+        return false;
+
+    const usb_standard_desc_t *desc = (const usb_standard_desc_t *)cfg;
+    int offset = 0;
+
+    while ((desc = usb_parse_next_descriptor_of_type(
+                desc, cfg->wTotalLength, USB_B_DESCRIPTOR_TYPE_INTERFACE,
+                &offset)) != NULL)
+    {
+        const usb_intf_desc_t *intf = (const usb_intf_desc_t *)desc;
+        if (intf->bInterfaceClass != USB_CLASS_AUDIO ||
+            intf->bInterfaceSubClass != MIDI_SUBCLASS_STREAMING ||
+            intf->bAlternateSetting != 0)
+            continue;
+
+        for (int i = 0; i < intf->bNumEndpoints; i++)
+        {
+            int ep_offset = offset;
+            const usb_ep_desc_t *ep = usb_parse_endpoint_descriptor_by_index(
+                intf, i, cfg->wTotalLength, &ep_offset);
+            if (ep == NULL) break;
+
+            if ((ep->bEndpointAddress & USB_B_ENDPOINT_ADDRESS_EP_DIR_MASK) &&
+                (ep->bmAttributes & USB_BM_ATTRIBUTES_XFERTYPE_MASK) ==
+                    USB_BM_ATTRIBUTES_XFER_BULK)
+            {
+                dev->interface = intf->bInterfaceNumber;
+                dev->ep_addr = ep->bEndpointAddress;
+                dev->ep_mps = USB_EP_DESC_GET_MPS(ep);
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+static void midi_device_open(struct class_driver_control *drv,
+                             midi_device_t *dev)
+{
+    esp_err_t err =
+        usb_host_device_open(drv->client_hdl, dev->dev_addr, &dev->dev_hdl);
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to open device %d: %d", dev->dev_addr, err);
+        dev->dev_hdl = NULL;
+        return;
+    }
+
+    if (!midi_find_endpoint(dev) ||
+        usb_host_interface_claim(drv->client_hdl, dev->dev_hdl, dev->interface,
+                                 0) != ESP_OK)
+    {
+        // Not a MIDI device (or a hub), leave it to the other clients
+        ESP_LOGI(TAG, "No MIDI endpoint found on device %d", dev->dev_addr);
+        usb_host_device_close(drv->client_hdl, dev->dev_hdl);
+        dev->dev_hdl = NULL;
+        return;
+    }
+
+    usb_device_info_t dev_info;
+    ESP_ERROR_CHECK(usb_host_device_info(dev->dev_hdl, &dev_info));
+    const usb_str_desc_t *str_desc = dev_info.str_desc_product;
+    int n = 0;
+    for (int i = 0; str_desc && i < str_desc->bLength / 2 - 1; i++)
+    {
+        /*
+        USB String descriptors of UTF-16.
+        Right now We just skip any character larger than 0xFF to
+        stay in BMP Basic Latin and Latin-1 Supplement range.
+        */
+        if (str_desc->wData[i] > 0xFF)
+        {
+            continue;
+        }
+        if (n == DEV_NAME_LEN - 1) break;
+        dev->name[n] = (char)str_desc->wData[i];
+        n++;
+    }
+    if (n == 0)
+        n = snprintf(dev->name, DEV_NAME_LEN, "USB MIDI %d", dev->dev_addr);
+    dev->name[n] = '\0';
+
+    memset(dev->notes_on, 0, sizeof(dev->notes_on));
+    dev->messages = 0;
+    dev->window_count = 0;
+    dev->rate_hz = 0;
+    dev->peak_rate_hz = 0;
+    dev->errors = 0;
+    dev->error_run = 0;
+    dev->connected_us = esp_timer_get_time();
+    dev->window_start_us = dev->connected_us;
+    dev->open = true;
+    open_count++;
+    last_dev_name = dev->name;
+
+    ESP_LOGI(TAG, "found MIDI interface on device %d: %s", dev->dev_addr,
+             dev->name);
+    midi_notify(MIDI_EVENT_DEV_CONNECTED, dev);
+
+    uint16_t size = dev->ep_mps > MIDI_PACKET_SIZE ? dev->ep_mps
+                                                   : MIDI_PACKET_SIZE;
+    for (int i = 0; i < MIDI_TRANSFERS; i++)
+    {
+        usb_transfer_t *transfer;
+        if (usb_host_transfer_alloc(size, 0, &transfer) != ESP_OK) break;
+        transfer->num_bytes = size;
+        transfer->bEndpointAddress = dev->ep_addr;
+        transfer->callback = midi_in_cb;
+        transfer->context = dev;
+        transfer->device_handle = dev->dev_hdl;
+        dev->transfers[i] = transfer;
+
+        if (usb_host_transfer_submit(transfer) == ESP_OK) dev->in_flight++;
+    }
+}
+
+static void midi_device_close(struct class_driver_control *drv,
+                              midi_device_t *dev)
+{
+    if (dev->open)
+    {
+        dev->open = false;
+        open_count--;
+
+        // Release what the device was still holding, the other devices
+        // keep playing
+        int64_t now = esp_timer_get_time();
+        for (int ch = 0; ch < 16; ch++)
+        {
+            for (int note = 0; note < 128; note++)
+            {
+                if (!(dev->notes_on[ch][note >> 5] & (1UL << (note & 31))))
+                    continue;
+                midi_message_t msg = {
+                    .type = MIDI_MSG_NOTE,
+                    .channel = ch,
+                    .note = note,
+                };
+                midi_event_data_t event = {
+                    .type = MIDI_EVENT_MSG_RECEIVED,
+                    .msg = msg,
+                    .source = MIDI_SOURCE_USB,
+                    .device = dev - drv->devices,
+                    .time_us = now,
+                    .dev_name = dev->name,
+                };
+                if (midi_event_callback) midi_event_callback(&event);
+            }
+        }
+
+        ESP_LOGI(TAG, "USB device disconnected: %s", dev->name);
+        if (last_dev_name == dev->name)
+        {
+            last_dev_name = NULL;
+            for (int i = 0; i < MIDI_MAX_DEVICES; i++)
+                if (drv->devices[i].open) last_dev_name = drv->devices[i].name;
+        }
+        midi_notify(MIDI_EVENT_DEV_DISCONNECTED, dev);
+
+        usb_host_interface_release(drv->client_hdl, dev->dev_hdl,
+                                   dev->interface);
+    }
+
+    for (int i = 0; i < MIDI_TRANSFERS; i++)
+    {
+        if (dev->transfers[i] == NULL) continue;
+        usb_host_transfer_free(dev->transfers[i]);
+        dev->transfers[i] = NULL;
+    }
+
+    if (dev->dev_hdl != NULL)
+    {
+        usb_host_device_close(drv->client_hdl, dev->dev_hdl);
+        dev->dev_hdl = NULL;
+    }
+}
+
 static void client_event_cb(const usb_host_client_event_msg_t *event_msg,
                             void *arg)
 {
-    struct class_driver_control *class_driver_obj =
-        (struct class_driver_control *)arg;
+    struct class_driver_control *drv = (struct class_driver_control *)arg;
+
     switch (event_msg->event)
     {
     case USB_HOST_CLIENT_EVENT_NEW_DEV:
-        class_driver_obj->dev_addr = event_msg->new_dev.address;
-        class_driver_obj->dev_hdl = NULL;
-        class_driver_obj->actions |= ACTION_OPEN_DEV;
+        for (int i = 0; i < MIDI_MAX_DEVICES; i++)
+        {
+            midi_device_t *dev = &drv->devices[i];
+            if (dev->dev_hdl != NULL || dev->actions) continue;
+            dev->dev_addr = event_msg->new_dev.address;
+            dev->actions |= ACTION_OPEN_DEV;
+            return;
+        }
+        ESP_LOGW(TAG, "Device table full, device %d ignored",
+                 event_msg->new_dev.address);
         break;
     case USB_HOST_CLIENT_EVENT_DEV_GONE:
-        class_driver_obj->actions |= ACTION_CLOSE_DEV;
+        for (int i = 0; i < MIDI_MAX_DEVICES; i++)
+        {
+            midi_device_t *dev = &drv->devices[i];
+            if (dev->dev_hdl == event_msg->dev_gone.dev_hdl)
+                dev->actions |= ACTION_CLOSE_DEV;
+        }
         break;
     default:
         ESP_LOGI(TAG, "oula");
@@ -281,41 +546,60 @@ static void client_event_cb(const usb_host_client_event_msg_t *event_msg,
 
 static void midi_in_cb(usb_transfer_t *transfer)
 {
-    for (int i = 0; i < transfer->actual_num_bytes; i += 4)
+    midi_device_t *dev = (midi_device_t *)transfer->context;
+    int64_t now = esp_timer_get_time();
+
+    dev->in_flight--;
+
+    for (int i = 0; i + 3 < transfer->actual_num_bytes; i += 4)
     {
+        // Code index number, channel messages (0x8..0xE) and single bytes
+        // (0xF) which carry the realtime messages
         uint8_t cin = transfer->data_buffer[i] & 0x0F;
-        uint8_t note = transfer->data_buffer[i + 2];
-        uint8_t vel = transfer->data_buffer[i + 3];
+        if (cin < 0x8) continue;
 
-        midi_message_t msg = {.note = note};
-
-        switch (cin)
-        {
-        case 0x9: // Note On
-            ESP_LOGI("MIDI", "Note On: %d Velocity %d", note, vel);
-            msg.state = 1;
-            msg.velocity = vel;
-            break;
-        case 0x8: // Note Off
-            ESP_LOGI("MIDI", "Note Off: %d", note);
-            break;
-        default:
-            break;
-        }
+        midi_message_t msg;
+        if (midi_decode(transfer->data_buffer[i + 1],
+                        transfer->data_buffer[i + 2],
+                        transfer->data_buffer[i + 3], &msg))
+            midi_device_post(dev, &msg, now);
+    }
 
-        event_data.type = MIDI_EVENT_MSG_RECEIVED;
-        event_data.msg = msg;
-        if (midi_event_callback) midi_event_callback(&event_data);
+    if (now - dev->window_start_us >= RATE_WINDOW_US)
+    {
+        dev->rate_hz = (uint32_t)((uint64_t)dev->window_count * 1000000 /
+                                  (now - dev->window_start_us));
+        if (dev->rate_hz > dev->peak_rate_hz) dev->peak_rate_hz = dev->rate_hz;
+        dev->window_count = 0;
+        dev->window_start_us = now;
     }
 
-    if (transfer->actual_num_bytes > 0 && transfer_active &&
-        transfer->device_handle != NULL)
+    // Canceled or gone: the device is closing and takes its transfers back
+    if (transfer->status == USB_TRANSFER_STATUS_CANCELED ||
+        transfer->status == USB_TRANSFER_STATUS_NO_DEVICE || !dev->open ||
+        (dev->actions & ACTION_CLOSE_DEV))
+        return;
+
+    // Anything else is polled again, or the device would fall silent one
+    // transfer at a time
+    if (transfer->status == USB_TRANSFER_STATUS_COMPLETED)
     {
-        esp_err_t ret = usb_host_transfer_submit(transfer);
-        if (ret != ESP_OK)
+        dev->error_run = 0;
+    }
+    else
+    {
+        dev->errors++;
+        if (++dev->error_run > MIDI_ERRORS_MAX)
         {
-            ESP_LOGE(TAG, "Failed to resubmit: %d", ret);
-            transfer_active = false;
+            ESP_LOGE(TAG, "%s: IN transfer failing (%d), given up", dev->name,
+                     transfer->status);
+            return;
         }
     }
+
+    esp_err_t ret = usb_host_transfer_submit(transfer);
+    if (ret == ESP_OK)
+        dev->in_flight++;
+    else
+        ESP_LOGE(TAG, "Failed to resubmit: %d", ret);
 }
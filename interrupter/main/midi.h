@@ -27,23 +27,49 @@ extern "C"
 // -----------------------------------------------------------------------------
 // Includes
 // -----------------------------------------------------------------------------
+#include "sdkconfig.h"
 #include <stdint.h>
 #include <stdbool.h>
 
 // -----------------------------------------------------------------------------
 // Macros and Constants
 // -----------------------------------------------------------------------------
+#define MIDI_MAX_DEVICES CONFIG_INTERRUPT_MIDI_MAX_DEVICES
+#define MIDI_CHANNEL_KEEP -1
 
 // -----------------------------------------------------------------------------
 // Type Definitions
 // -----------------------------------------------------------------------------
+typedef enum
+{
+    MIDI_MSG_NOTE,
+    MIDI_MSG_CONTROL_CHANGE,
+    MIDI_MSG_PITCH_BEND,
+    MIDI_MSG_PROGRAM_CHANGE,
+    MIDI_MSG_CLOCK, // System realtime from here, channel is unused
+    MIDI_MSG_START,
+    MIDI_MSG_CONTINUE,
+    MIDI_MSG_STOP,
+} midi_msg_type_t;
+
 typedef struct
 {
+    midi_msg_type_t type;
+    uint8_t channel;
     bool state;
-    uint8_t note;
-    uint8_t velocity;
+    uint8_t note;     // Note, controller number for CC, or program
+    uint8_t velocity; // Note velocity, or controller value for CC
+    int16_t bend;     // Pitch bend, -8192..8191
 } midi_message_t;
 
+typedef enum
+{
+    MIDI_SOURCE_USB,
+    MIDI_SOURCE_UART,
+    MIDI_SOURCE_PLAYER,
+    MIDI_SOURCE_RECORDER,
+} midi_source_t;
+
 typedef enum
 {
     MIDI_EVENT_DEV_CONNECTED,
@@ -55,9 +81,24 @@ typedef struct
 {
     midi_event_t type;
     midi_message_t msg;
+    midi_source_t source;
+    uint8_t device;  // USB device slot
+    int64_t time_us; // esp_timer time the message was received
     char *dev_name;
 } midi_event_data_t;
 
+typedef struct
+{
+    const char *name;
+    uint8_t address;
+    int8_t channel;        // Forced channel, or MIDI_CHANNEL_KEEP
+    uint32_t messages;
+    uint32_t rate_hz;      // Messages per second over the last window
+    uint32_t peak_rate_hz;
+    uint32_t errors;       // IN transfers completed with an error
+    int64_t connected_us;
+} midi_device_stats_t;
+
 // -----------------------------------------------------------------------------
 // Inline Function Definitions
 // -----------------------------------------------------------------------------
@@ -70,6 +111,10 @@ void midi_init(void);
 void midi_set_event_callback(void (*cb)(midi_event_data_t *event));
 const char *midi_get_device_name(void);
 bool midi_is_connected();
+bool midi_get_device_stats(uint8_t slot, midi_device_stats_t *stats);
+void midi_set_channel_remap(uint8_t slot, int8_t channel);
+void midi_post(midi_source_t source, const midi_message_t *msg,
+               int64_t time_us);
 
 void midi_free(void);
 
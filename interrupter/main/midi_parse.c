@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file midi_parse.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "midi_parse.h"
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define STATUS_SYSEX 0xF0
+#define STATUS_REALTIME 0xF8 // 0xF8..0xFF, single byte
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+void midi_parser_init(midi_parser_t *parser)
+{
+    memset(parser, 0, sizeof(*parser));
+}
+
+bool midi_parser_feed(midi_parser_t *parser, uint8_t byte, midi_message_t *msg)
+{
+    // Realtime bytes may come anywhere, even inside another message
+    if (byte >= STATUS_REALTIME) return midi_decode(byte, 0, 0, msg);
+
+    if (byte & 0x80)
+    {
+        parser->count = 0;
+        parser->sysex = byte == STATUS_SYSEX;
+        // System common messages cancel running status, those with data
+        // bytes are still parsed so the data is not taken for a message
+        parser->status = midi_data_length(byte) > 0 ? byte : 0;
+        return false;
+    }
+
+    if (parser->sysex || parser->status == 0) return false;
+
+    parser->data[parser->count++] = byte;
+    if (parser->count < midi_data_length(parser->status)) return false;
+
+    parser->count = 0;
+    uint8_t status = parser->status;
+    if (status >= STATUS_SYSEX) parser->status = 0;
+
+    return midi_decode(status, parser->data[0], parser->data[1], msg);
+}
+
+uint8_t midi_data_length(uint8_t status)
+{
+    switch (status & 0xF0)
+    {
+    case 0xC0: // Program Change
+    case 0xD0: // Channel Pressure
+        return 1;
+    case 0xF0:
+        if (status == 0xF1 || status == 0xF3) return 1; // MTC, Song Select
+        if (status == 0xF2) return 2;                   // Song Position
+        return 0;
+    default:
+        return 2;
+    }
+}
+
+bool midi_decode(uint8_t status, uint8_t data1, uint8_t data2,
+                 midi_message_t *msg)
+{
+    memset(msg, 0, sizeof(*msg));
+    msg->channel = status & 0x0F;
+    msg->note = data1 & 0x7F;
+    data2 &= 0x7F;
+
+    switch (status & 0xF0)
+    {
+    case 0x90: // Note On, velocity 0 is a Note Off
+        msg->type = MIDI_MSG_NOTE;
+        msg->state = data2 > 0;
+        msg->velocity = data2;
+        return true;
+    case 0x80: // Note Off
+        msg->type = MIDI_MSG_NOTE;
+        return true;
+    case 0xB0: // Control Change
+        msg->type = MIDI_MSG_CONTROL_CHANGE;
+        msg->velocity = data2;
+        return true;
+    case 0xC0: // Program Change
+        msg->type = MIDI_MSG_PROGRAM_CHANGE;
+        return true;
+    case 0xE0: // Pitch Bend, 14 bits LSB first
+        msg->type = MIDI_MSG_PITCH_BEND;
+        msg->bend = (int16_t)((data2 << 7) | msg->note) - 8192;
+        return true;
+    case 0xF0:
+        break;
+    default:
+        return false;
+    }
+
+    msg->channel = 0;
+    msg->note = 0;
+    switch (status)
+    {
+    case 0xF8:
+        msg->type = MIDI_MSG_CLOCK;
+        return true;
+    case 0xFA:
+        msg->type = MIDI_MSG_START;
+        return true;
+    case 0xFB:
+        msg->type = MIDI_MSG_CONTINUE;
+        return true;
+    case 0xFC:
+        msg->type = MIDI_MSG_STOP;
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool midi_encode(const midi_message_t *msg, uint8_t bytes[3])
+{
+    uint8_t channel = msg->channel & 0x0F;
+
+    switch (msg->type)
+    {
+    case MIDI_MSG_NOTE:
+        bytes[0] = (msg->state ? 0x90 : 0x80) | channel;
+        bytes[1] = msg->note & 0x7F;
+        bytes[2] = msg->velocity & 0x7F;
+        return true;
+    case MIDI_MSG_CONTROL_CHANGE:
+        bytes[0] = 0xB0 | channel;
+        bytes[1] = msg->note & 0x7F;
+        bytes[2] = msg->velocity & 0x7F;
+        return true;
+    case MIDI_MSG_PROGRAM_CHANGE:
+        bytes[0] = 0xC0 | channel;
+        bytes[1] = msg->note & 0x7F;
+        bytes[2] = 0;
+        return true;
+    case MIDI_MSG_PITCH_BEND:
+    {
+        uint16_t value = (uint16_t)(msg->bend + 8192);
+        bytes[0] = 0xE0 | channel;
+        bytes[1] = value & 0x7F;
+        bytes[2] = (value >> 7) & 0x7F;
+        return true;
+    }
+    default:
+        return false;
+    }
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file midi_parse.h
+ * @brief MIDI 1.0 byte stream parser
+ *
+ * Turns raw MIDI bytes (DIN/serial input) into midi_message_t, with running
+ * status. Realtime bytes may be interleaved anywhere, clock and transport
+ * are returned at once and the message in progress is left untouched.
+ * System exclusive data is skipped. midi_decode() is shared by every
+ * source (USB packets, MIDI files) so they all produce the same messages,
+ * midi_encode() packs one back into its three bytes. No platform
+ * dependency, the parser also builds on the host.
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+#ifndef MIDI_PARSE_H
+#define MIDI_PARSE_H
+
+// clang-format off
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "midi.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+typedef struct
+{
+    uint8_t status;  // Running status, 0 when none
+    uint8_t data[2];
+    uint8_t count;   // Data bytes received for the current message
+    bool sysex;
+} midi_parser_t;
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+void midi_parser_init(midi_parser_t *parser);
+bool midi_parser_feed(midi_parser_t *parser, uint8_t byte, midi_message_t *msg);
+
+uint8_t midi_data_length(uint8_t status);
+bool midi_decode(uint8_t status, uint8_t data1, uint8_t data2,
+                 midi_message_t *msg);
+bool midi_encode(const midi_message_t *msg, uint8_t bytes[3]);
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
+
+#endif /* !MIDI_PARSE_H */
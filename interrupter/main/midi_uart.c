@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file midi_uart.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "midi_uart.h"
+#include "driver/gpio.h"
+#include "driver/uart.h"
+#include "esp_cpu.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "midi.h"
+#include "midi_parse.h"
+#include "sdkconfig.h"
+#include "tasks.h"
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define MIDI_UART_NUM CONFIG_INTERRUPT_MIDI_UART_NUM
+#define PIN_MIDI_RX CONFIG_INTERRUPT_PIN_MIDI_RX
+#define RX_BUF_SIZE CONFIG_INTERRUPT_MIDI_UART_RX_BUF
+
+#define MIDI_BAUD 31250
+#define MIDI_BYTE_US (10 * 1000000 / MIDI_BAUD) // 8N1, 320 us
+
+// Hand bytes to the ring buffer as soon as a whole message is in the FIFO,
+// or after 2 idle byte times for shorter (running status) messages
+#define RX_FULL_THRESH 3
+#define RX_TIMEOUT_SYMBOLS 2
+
+#define RX_CHUNK 64
+#define EVENT_QUEUE_LEN 16
+
+#define TAG "midi_uart"
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static QueueHandle_t uart_queue = NULL;
+static TaskHandle_t uart_task_hdl = NULL;
+
+static midi_parser_t parser;
+static midi_uart_stats_t stats = {0};
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static void midi_uart_process(const uint8_t *buf, int len, int64_t now)
+{
+    midi_message_t msg;
+
+    stats.bytes += len;
+
+    for (int i = 0; i < len; i++)
+    {
+        uint32_t c0 = esp_cpu_get_cycle_count();
+        bool complete = midi_parser_feed(&parser, buf[i], &msg);
+        stats.parse_cycles += esp_cpu_get_cycle_count() - c0;
+        if (!complete) continue;
+
+        // Bytes still behind this one in the chunk arrived later
+        int64_t arrival = now - (int64_t)(len - 1 - i) * MIDI_BYTE_US;
+        midi_post(MIDI_SOURCE_UART, &msg, arrival);
+
+        uint32_t latency = (uint32_t)(esp_timer_get_time() - arrival);
+        if (latency > stats.latency_us_max) stats.latency_us_max = latency;
+        stats.latency_us_total += latency;
+        stats.messages++;
+    }
+}
+
+static void midi_uart_task(void *pvParams)
+{
+    static uint8_t buf[RX_CHUNK];
+    uart_event_t event;
+
+    while (1)
+    {
+        if (xQueueReceive(uart_queue, &event, portMAX_DELAY) != pdPASS)
+            continue;
+
+        switch (event.type)
+        {
+        case UART_DATA:
+        {
+            size_t available = event.size;
+            while (available > 0)
+            {
+                int n = uart_read_bytes(MIDI_UART_NUM, buf,
+                                        available < RX_CHUNK ? available
+                                                             : RX_CHUNK,
+                                        0);
+                if (n <= 0) break;
+                midi_uart_process(buf, n, esp_timer_get_time());
+                available -= n;
+            }
+            break;
+        }
+        case UART_FIFO_OVF:
+        case UART_BUFFER_FULL:
+            ESP_LOGW(TAG, "RX overflow, input flushed");
+            stats.overruns++;
+            uart_flush_input(MIDI_UART_NUM);
+            xQueueReset(uart_queue);
+            midi_parser_init(&parser);
+            break;
+        case UART_FRAME_ERR:
+        case UART_BREAK:
+            // Cable plugged or unplugged, resync on the next status byte
+            midi_parser_init(&parser);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+esp_err_t midi_uart_init(void)
+{
+    const uart_config_t uart_cfg = {
+        .baud_rate = MIDI_BAUD,
+        .data_bits = UART_DATA_8_BITS,
+        .parity = UART_PARITY_DISABLE,
+        .stop_bits = UART_STOP_BITS_1,
+        .flow_ctrl = UART_HW_FLOWCTRL_DISABLE,
+        .source_clk = UART_SCLK_DEFAULT,
+    };
+
+    esp_err_t err = uart_driver_install(MIDI_UART_NUM, RX_BUF_SIZE, 0,
+                                        EVENT_QUEUE_LEN, &uart_queue, 0);
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Driver install failed: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    ESP_ERROR_CHECK(uart_param_config(MIDI_UART_NUM, &uart_cfg));
+    ESP_ERROR_CHECK(uart_set_pin(MIDI_UART_NUM, UART_PIN_NO_CHANGE, PIN_MIDI_RX,
+                                 UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE));
+    // Opto-isolator output is open collector
+    gpio_set_pull_mode(PIN_MIDI_RX, GPIO_PULLUP_ONLY);
+
+    ESP_ERROR_CHECK(uart_set_rx_full_threshold(MIDI_UART_NUM, RX_FULL_THRESH));
+    ESP_ERROR_CHECK(uart_set_rx_timeout(MIDI_UART_NUM, RX_TIMEOUT_SYMBOLS));
+
+    midi_parser_init(&parser);
+
+    uart_task_hdl = task_start(TASK_MIDI_UART, midi_uart_task, NULL);
+
+    ESP_LOGI(TAG, "Serial MIDI input on GPIO %d", PIN_MIDI_RX);
+    return ESP_OK;
+}
+
+void midi_uart_get_stats(midi_uart_stats_t *out) { *out = stats; }
+
+void midi_uart_reset_stats(void) { memset(&stats, 0, sizeof(stats)); }
@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file midi_uart.h
+ * @brief DIN/serial MIDI input
+ *
+ * 31250 baud input on CONFIG_INTERRUPT_PIN_MIDI_RX. The UART driver moves
+ * received bytes into its ring buffer from the RX interrupt; a task drains
+ * it through the running status parser and posts the messages with
+ * midi_post(), merged with the USB stream. Each message is stamped with the
+ * estimated arrival time of its last byte.
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+#ifndef MIDI_UART_H
+#define MIDI_UART_H
+
+// clang-format off
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "esp_err.h"
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t bytes;
+    uint32_t messages;
+    uint32_t overruns;         // Ring buffer or FIFO overflows
+    uint64_t parse_cycles;     // CPU cycles spent in the parser
+    uint32_t latency_us_max;   // Last byte arrival to message posted
+    uint64_t latency_us_total;
+} midi_uart_stats_t;
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+esp_err_t midi_uart_init(void);
+void midi_uart_get_stats(midi_uart_stats_t *stats);
+void midi_uart_reset_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
+
+#endif /* !MIDI_UART_H */
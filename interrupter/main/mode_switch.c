@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file mode_switch.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "mode_switch.h"
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+void mode_switch_init(mode_switch_t *sw, pwm_mode_t mode,
+                      const output_backend_t *pulse,
+                      const output_backend_t *duty,
+                      const mode_switch_hooks_t *hooks)
+{
+    sw->mode = mode;
+    sw->pulse = pulse;
+    sw->duty = duty;
+    sw->hooks = *hooks;
+
+    output_init(mode_switch_backend(sw, mode));
+}
+
+const output_backend_t *mode_switch_backend(const mode_switch_t *sw,
+                                            pwm_mode_t mode)
+{
+    if (mode == PWM_AUDIO || mode == PWM_CLIPS) return sw->duty;
+    return sw->pulse;
+}
+
+bool mode_switch_set(mode_switch_t *sw, pwm_mode_t mode)
+{
+    if (mode == sw->mode) return false;
+
+    const output_backend_t *backend = mode_switch_backend(sw, mode);
+    if (backend == NULL) return false;
+
+    sw->hooks.leave(sw->mode, sw->hooks.ctx);
+    output_stop();
+
+    sw->mode = mode;
+    output_select(backend);
+    output_start();
+
+    sw->hooks.enter(mode, sw->hooks.ctx);
+    return true;
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file mode_switch.h
+ * @brief Output mode transitions shared by the firmware and the host tests
+ *
+ * Which backend each mode drives the pin with, pulses for the manual and
+ * MIDI modes and duty for the audio and clip modes, and the order of a
+ * switch: the old mode is left, the output stopped, the backend of the new
+ * mode selected and started, then the new mode entered. Audio and clips
+ * are refused without a duty backend. pwm.c supplies the peripheral work
+ * of each mode as hooks, the pin is only reached through output.h.
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+#ifndef MODE_SWITCH_H
+#define MODE_SWITCH_H
+
+// clang-format off
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "output.h"
+#include "pwm.h"
+#include <stdbool.h>
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+typedef struct
+{
+    void (*leave)(pwm_mode_t mode, void *ctx); // Before the output stops
+    void (*enter)(pwm_mode_t mode, void *ctx); // Once the backend started
+    void *ctx;
+} mode_switch_hooks_t;
+
+typedef struct
+{
+    pwm_mode_t mode;
+    const output_backend_t *pulse; // Manual and MIDI
+    const output_backend_t *duty;  // Audio and clips, NULL when not built
+    mode_switch_hooks_t hooks;
+} mode_switch_t;
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+// Starts the output disarmed on the backend of mode, which must have one
+void mode_switch_init(mode_switch_t *sw, pwm_mode_t mode,
+                      const output_backend_t *pulse,
+                      const output_backend_t *duty,
+                      const mode_switch_hooks_t *hooks);
+
+// NULL when the mode is not available
+const output_backend_t *mode_switch_backend(const mode_switch_t *sw,
+                                            pwm_mode_t mode);
+
+// False when already in the mode or refused, nothing is touched then
+bool mode_switch_set(mode_switch_t *sw, pwm_mode_t mode);
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
+
+#endif /* !MODE_SWITCH_H */
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file output.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "output.h"
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+// Set by output_init(), before any output
+const output_backend_t *volatile output_current = NULL;
+static bool armed = false;
+
+volatile output_counters_t output_counters = {0};
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+// Starts disarmed on the given backend
+void output_init(const output_backend_t *backend)
+{
+    output_current = backend;
+    armed = false;
+    backend->disarm();
+}
+
+// Hands the pin over to another backend, armed stays armed
+void output_select(const output_backend_t *backend)
+{
+    if (backend == output_current) return;
+
+    if (armed)
+    {
+        output_current->disarm();
+        backend->arm();
+    }
+    output_current = backend;
+}
+
+void output_start(void) { output_current->start(); }
+
+void output_stop(void)
+{
+    output_current->stop();
+    output_counters.train_period_tick = 0;
+}
+
+void output_arm(void)
+{
+    armed = true;
+    output_current->arm();
+}
+
+void output_disarm(void)
+{
+    armed = false;
+    output_current->disarm();
+}
+
+bool output_is_armed(void) { return armed; }
+
+uint32_t output_train_max(void) { return output_current->train_max_tick; }
@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file output.h
+ * @brief Output pin backends
+ *
+ * A backend drives the output pin from one peripheral: output_rmt for the
+ * pulses of the manual and MIDI modes, output_ledc for the duty of the
+ * audio and clip modes, output_mock on the host. mode_switch.c picks the
+ * backend of each mode, it and pwm.c only go through these calls.
+ *
+ * The pulse and duty calls run in ISRs. They dispatch through the current
+ * backend, unless a single backend is built (OUTPUT_STATIC_BACKEND): the
+ * calls are then bound at compile time and cost a direct call.
+ *
+ * They also count what goes out in output_counters, for the telemetry. Each
+ * counter has a single writer, the mode in use, and is read without lock.
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+// clang-format off
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "sdkconfig.h"
+#include "voice.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define OUTPUT_TICK_HZ VOICE_TICK_HZ // Pulse widths and periods
+
+// Firmware without the LEDC backend only has the RMT one
+#if !defined(OUTPUT_STATIC_BACKEND) && defined(ESP_PLATFORM) && \
+    !CONFIG_INTERRUPT_OUTPUT_LEDC
+#define OUTPUT_STATIC_BACKEND output_rmt
+#endif
+
+#define OUTPUT_CAT_(a, b) a##_##b
+#define OUTPUT_CAT(a, b) OUTPUT_CAT_(a, b)
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+// Every operation is implemented, unsupported ones do nothing
+typedef struct
+{
+    const char *name;
+    void (*init)(void);
+    void (*start)(void);  // Ready for the new mode
+    void (*stop)(void);   // Output stopped, pin low
+    void (*arm)(void);    // Peripheral routed to the pin
+    void (*disarm)(void); // Pin detached and low
+    void (*pulse)(uint16_t width_tick);
+    void (*train)(uint32_t period_tick, uint32_t width_tick); // 0: stop
+    void (*duty)(uint8_t duty);
+    uint32_t train_max_tick; // Longest period train() can repeat
+} output_backend_t;
+
+// Free running, readers work on differences
+typedef struct
+{
+    uint32_t pulses;            // Single pulses
+    uint32_t on_tick;           // Sum of their widths
+    uint32_t duty_sum;          // Sum of the duty updates, 255 is full on
+    uint32_t duty_updates;
+    uint32_t train_period_tick; // Repeating train, 0 when none
+    uint32_t train_width_tick;
+} output_counters_t;
+
+// -----------------------------------------------------------------------------
+// Variable Declarations
+// -----------------------------------------------------------------------------
+extern const output_backend_t output_rmt;
+extern const output_backend_t output_ledc;
+extern const output_backend_t output_mock;
+
+extern const output_backend_t *volatile output_current;
+
+extern volatile output_counters_t output_counters;
+
+// -----------------------------------------------------------------------------
+// Inline Function Definitions
+// -----------------------------------------------------------------------------
+#ifdef OUTPUT_STATIC_BACKEND
+void OUTPUT_CAT(OUTPUT_STATIC_BACKEND, pulse)(uint16_t width_tick);
+void OUTPUT_CAT(OUTPUT_STATIC_BACKEND, train)(uint32_t period_tick,
+                                              uint32_t width_tick);
+void OUTPUT_CAT(OUTPUT_STATIC_BACKEND, duty)(uint8_t duty);
+
+#define OUTPUT_CALL(op) OUTPUT_CAT(OUTPUT_STATIC_BACKEND, op)
+#else
+#define OUTPUT_CALL(op) output_current->op
+#endif
+
+static inline void output_pulse(uint16_t width_tick)
+{
+    output_counters.pulses++;
+    output_counters.on_tick += width_tick;
+    OUTPUT_CALL(pulse)(width_tick);
+}
+
+static inline void output_train(uint32_t period_tick, uint32_t width_tick)
+{
+    output_counters.train_period_tick = period_tick;
+    output_counters.train_width_tick = width_tick;
+    OUTPUT_CALL(train)(period_tick, width_tick);
+}
+
+static inline void output_duty(uint8_t duty)
+{
+    output_counters.duty_sum += duty;
+    output_counters.duty_updates++;
+    OUTPUT_CALL(duty)(duty);
+}
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+void output_init(const output_backend_t *backend);
+void output_select(const output_backend_t *backend);
+void output_start(void);
+void output_stop(void);
+void output_arm(void);
+void output_disarm(void);
+bool output_is_armed(void);
+uint32_t output_train_max(void);
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
+
+#endif /* !OUTPUT_H */
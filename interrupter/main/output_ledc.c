@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file output_ledc.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "output.h"
+#include "driver/ledc.h"
+#include "rom/gpio.h"
+#include "sdkconfig.h"
+#include "soc/gpio_reg.h"
+#include "soc/gpio_sig_map.h"
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define PIN_OUTPUT CONFIG_INTERRUPT_PIN_OUTPUT
+
+#define LEDC_TIMER LEDC_TIMER_0
+#define LEDC_MODE LEDC_LOW_SPEED_MODE
+#define LEDC_CHANNEL LEDC_CHANNEL_0
+#define LEDC_DUTY_RES LEDC_TIMER_8_BIT
+#define LEDC_FREQUENCY (30e3)
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+void output_ledc_init(void)
+{
+    ledc_channel_config_t ledc_channel = {.speed_mode = LEDC_MODE,
+                                          .channel = LEDC_CHANNEL,
+                                          .timer_sel = LEDC_TIMER,
+                                          .intr_type = LEDC_INTR_DISABLE,
+                                          .gpio_num = PIN_OUTPUT,
+                                          .duty = 0,
+                                          .hpoint = 0};
+    ESP_ERROR_CHECK(ledc_channel_config(&ledc_channel));
+
+    // Prepare and then apply the LEDC PWM timer configuration
+    ledc_timer_config_t ledc_timer = {.speed_mode = LEDC_MODE,
+                                      .duty_resolution = LEDC_DUTY_RES,
+                                      .timer_num = LEDC_TIMER,
+                                      .freq_hz = LEDC_FREQUENCY,
+                                      .clk_cfg = LEDC_AUTO_CLK};
+    ESP_ERROR_CHECK(ledc_timer_config(&ledc_timer));
+}
+
+void output_ledc_start(void) {}
+
+void output_ledc_stop(void)
+{
+    ledc_stop(LEDC_MODE, LEDC_CHANNEL, 0);
+    WRITE_PERI_REG(GPIO_OUT_W1TC_REG, (1ULL << PIN_OUTPUT));
+}
+
+void output_ledc_arm(void)
+{
+    gpio_matrix_out(PIN_OUTPUT, LEDC_LS_SIG_OUT0_IDX, 0, 0);
+}
+
+void output_ledc_disarm(void)
+{
+    gpio_matrix_out(PIN_OUTPUT, SIG_GPIO_OUT_IDX, 0, 0);
+    WRITE_PERI_REG(GPIO_OUT_W1TC_REG, (1ULL << PIN_OUTPUT));
+}
+
+void output_ledc_pulse(uint16_t width_tick) { (void)width_tick; }
+
+void output_ledc_train(uint32_t period_tick, uint32_t width_tick)
+{
+    (void)period_tick;
+    (void)width_tick;
+}
+
+void output_ledc_duty(uint8_t duty)
+{
+    ESP_ERROR_CHECK(ledc_set_duty(LEDC_MODE, LEDC_CHANNEL, duty));
+    ESP_ERROR_CHECK(ledc_update_duty(LEDC_MODE, LEDC_CHANNEL));
+}
+
+const output_backend_t output_ledc = {
+    .name = "ledc",
+    .init = output_ledc_init,
+    .start = output_ledc_start,
+    .stop = output_ledc_stop,
+    .arm = output_ledc_arm,
+    .disarm = output_ledc_disarm,
+    .pulse = output_ledc_pulse,
+    .train = output_ledc_train,
+    .duty = output_ledc_duty,
+    .train_max_tick = 0,
+};
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file output_mock.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "output_mock.h"
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static output_mock_state_t state;
+static output_mock_hooks_t hooks;
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static void output_mock_called(const char *op)
+{
+    if (hooks.call) hooks.call(op, hooks.ctx);
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+void output_mock_init(void) { memset(&state, 0, sizeof(state)); }
+
+void output_mock_start(void)
+{
+    state.starts++;
+    output_mock_called("start");
+}
+
+void output_mock_stop(void)
+{
+    state.stops++;
+    output_mock_called("stop");
+    state.period_tick = 0;
+    state.duty = 0;
+}
+
+void output_mock_arm(void)
+{
+    state.arms++;
+    state.armed = true;
+    output_mock_called("arm");
+}
+
+void output_mock_disarm(void)
+{
+    state.disarms++;
+    state.armed = false;
+    output_mock_called("disarm");
+}
+
+// Pulses reach the hook only while armed, like the real pin
+void output_mock_pulse(uint16_t width_tick)
+{
+    state.pulses++;
+    state.on_tick += width_tick;
+    if (state.armed && hooks.pulse) hooks.pulse(width_tick, hooks.ctx);
+}
+
+void output_mock_train(uint32_t period_tick, uint32_t width_tick)
+{
+    state.period_tick = period_tick;
+    state.width_tick = width_tick;
+}
+
+void output_mock_duty(uint8_t duty)
+{
+    state.duties++;
+    state.duty = duty;
+    if (state.armed && hooks.duty) hooks.duty(duty, hooks.ctx);
+}
+
+const output_backend_t output_mock = {
+    .name = "mock",
+    .init = output_mock_init,
+    .start = output_mock_start,
+    .stop = output_mock_stop,
+    .arm = output_mock_arm,
+    .disarm = output_mock_disarm,
+    .pulse = output_mock_pulse,
+    .train = output_mock_train,
+    .duty = output_mock_duty,
+    .train_max_tick = UINT32_MAX,
+};
+
+const output_mock_state_t *output_mock_get_state(void) { return &state; }
+
+void output_mock_set_hooks(const output_mock_hooks_t *new_hooks)
+{
+    hooks = *new_hooks;
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file output_mock.h
+ * @brief Output backend without hardware
+ *
+ * Counts the calls and keeps the last values so the mode logic can be
+ * checked on the host, and forwards the armed pulses and duties to hooks
+ * (tools/sim renders them). The other calls are reported by name, in the
+ * order they are made.
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+#ifndef OUTPUT_MOCK_H
+#define OUTPUT_MOCK_H
+
+// clang-format off
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "output.h"
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+typedef struct
+{
+    bool armed;
+    uint32_t starts;
+    uint32_t stops;
+    uint32_t arms;
+    uint32_t disarms;
+    uint32_t pulses;
+    uint32_t duties;
+    uint64_t on_tick;     // Sum of the pulse widths
+    uint32_t period_tick; // Current train, 0 when stopped
+    uint32_t width_tick;
+    uint8_t duty;
+} output_mock_state_t;
+
+typedef struct
+{
+    void (*pulse)(uint16_t width_tick, void *ctx);
+    void (*duty)(uint8_t duty, void *ctx);
+    void (*call)(const char *op, void *ctx); // start, stop, arm and disarm
+    void *ctx;
+} output_mock_hooks_t;
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+void output_mock_init(void);
+void output_mock_start(void);
+void output_mock_stop(void);
+void output_mock_arm(void);
+void output_mock_disarm(void);
+void output_mock_pulse(uint16_t width_tick);
+void output_mock_train(uint32_t period_tick, uint32_t width_tick);
+void output_mock_duty(uint8_t duty);
+
+const output_mock_state_t *output_mock_get_state(void);
+void output_mock_set_hooks(const output_mock_hooks_t *hooks);
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
+
+#endif /* !OUTPUT_MOCK_H */
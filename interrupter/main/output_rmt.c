@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file output_rmt.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "output.h"
+#include "driver/rmt.h"
+#include "esp_attr.h"
+#include "rom/gpio.h"
+#include "sdkconfig.h"
+#include "soc/gpio_reg.h"
+#include "soc/gpio_sig_map.h"
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define PIN_OUTPUT CONFIG_INTERRUPT_PIN_OUTPUT
+
+#define RMT_CHANNEL RMT_CHANNEL_0
+#define RMT_CLK_DIV 80 // 80 MHz / 80 = 1 MHz → 1 tick = 1 us
+#define RMT_DURATION_MAX 32767 // rmt_item32_t.duration0/1
+
+_Static_assert(80000000 / RMT_CLK_DIV == OUTPUT_TICK_HZ, "RMT tick");
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+void output_rmt_init(void)
+{
+    rmt_config_t config = {
+        .rmt_mode = RMT_MODE_TX,
+        .channel = RMT_CHANNEL,
+        .gpio_num = PIN_OUTPUT,
+        .clk_div = RMT_CLK_DIV,
+        .mem_block_num = 1,
+        .tx_config.loop_en = true,
+        .tx_config.carrier_en = false,
+        .tx_config.idle_level = RMT_IDLE_LEVEL_LOW,
+        .tx_config.idle_output_en = true,
+    };
+    rmt_config(&config);
+    rmt_driver_install(config.channel, 0, 0);
+}
+
+// Single pulses by default, train() switches to loop mode
+void output_rmt_start(void) { rmt_set_tx_loop_mode(RMT_CHANNEL, false); }
+
+void output_rmt_stop(void)
+{
+    rmt_tx_stop(RMT_CHANNEL);
+    WRITE_PERI_REG(GPIO_OUT_W1TC_REG, (1ULL << PIN_OUTPUT));
+}
+
+void output_rmt_arm(void)
+{
+    gpio_matrix_out(PIN_OUTPUT, RMT_SIG_OUT0_IDX, 0, 0);
+}
+
+void output_rmt_disarm(void)
+{
+    gpio_matrix_out(PIN_OUTPUT, SIG_GPIO_OUT_IDX, 0, 0);
+    WRITE_PERI_REG(GPIO_OUT_W1TC_REG, (1ULL << PIN_OUTPUT));
+}
+
+void IRAM_ATTR output_rmt_pulse(uint16_t width_tick)
+{
+    // duration1 = 0 is the end marker, the channel idles low afterwards
+    rmt_item32_t item = {
+        .level0 = 1, .duration0 = width_tick, .level1 = 0, .duration1 = 0};
+    rmt_fill_tx_items(RMT_CHANNEL, &item, 1, 0);
+    rmt_tx_start(RMT_CHANNEL, true);
+}
+
+void output_rmt_train(uint32_t period_tick, uint32_t width_tick)
+{
+    if (period_tick == 0 || width_tick == 0 || period_tick > RMT_DURATION_MAX)
+    {
+        rmt_tx_stop(RMT_CHANNEL);
+        rmt_set_tx_loop_mode(RMT_CHANNEL, false);
+        WRITE_PERI_REG(GPIO_OUT_W1TC_REG, (1ULL << PIN_OUTPUT));
+        return;
+    }
+
+    rmt_set_tx_loop_mode(RMT_CHANNEL, true);
+
+    rmt_item32_t item;
+    item.level0 = 1;
+    item.duration0 = width_tick; // high time
+    item.level1 = 0;
+    item.duration1 = period_tick - width_tick; // low time
+
+    rmt_write_items(RMT_CHANNEL, &item, 1, false);
+}
+
+void output_rmt_duty(uint8_t duty) { (void)duty; }
+
+const output_backend_t output_rmt = {
+    .name = "rmt",
+    .init = output_rmt_init,
+    .start = output_rmt_start,
+    .stop = output_rmt_stop,
+    .arm = output_rmt_arm,
+    .disarm = output_rmt_disarm,
+    .pulse = output_rmt_pulse,
+    .train = output_rmt_train,
+    .duty = output_rmt_duty,
+    .train_max_tick = RMT_DURATION_MAX,
+};
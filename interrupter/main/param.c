@@ -0,0 +1,327 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file param.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "param.h"
+#include "audio.h"
+#include "esp_log.h"
+#include "midi.h"
+#include "player.h"
+#include "pwm.h"
+#include "show.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define TAG "param"
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static int16_t values[PARAM_COUNT];
+static uint32_t pending = 0; // Set, waiting for the commit
+static const param_desc_t descs[PARAM_COUNT]; // Built after the callbacks
+
+_Static_assert(PARAM_COUNT <= 32, "One pending bit per parameter");
+_Static_assert(PARAM_COUNT <= SETTINGS_RECORDS, "One record per parameter");
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static uint8_t param_pattern(void) { return values[PARAM_PAT] - 1; }
+static uint8_t param_step(void) { return values[PARAM_STP] - 1; }
+
+// Back to manual mode unless something else still plays
+static void param_midi_idle(void)
+{
+    if (pwm_get_mode() == PWM_MIDI && !midi_is_connected() &&
+        !player_is_playing() && !show_is_playing() && !seq_is_running() &&
+        recorder_get_state() == REC_STOPPED)
+        pwm_set_mode(PWM_MANUAL);
+}
+
+static void param_seq_run(int16_t value)
+{
+    if (value)
+    {
+        pwm_set_mode(PWM_MIDI);
+        seq_start();
+    }
+    else
+    {
+        seq_stop();
+        param_midi_idle();
+    }
+}
+
+static int16_t param_seq_running(void) { return seq_is_running(); }
+static void param_set_tempo(int16_t value) { seq_set_tempo(value); }
+static int16_t param_get_tempo(void) { return seq_get_tempo(); }
+static void param_set_swing(int16_t value) { seq_set_swing(value); }
+static int16_t param_get_swing(void) { return seq_get_swing(); }
+static void param_set_arp(int16_t value) { seq_set_arp_mode(value); }
+static int16_t param_get_arp(void) { return seq_get_arp_mode(); }
+
+static void param_set_note(int16_t value)
+{
+    seq_step_t step = seq_get_pattern(param_pattern())->steps[param_step()];
+    step.note = value;
+    seq_set_step(param_pattern(), param_step(), step);
+}
+
+static int16_t param_get_note(void)
+{
+    return seq_get_pattern(param_pattern())->steps[param_step()].note;
+}
+
+static void param_set_velocity(int16_t value)
+{
+    seq_step_t step = seq_get_pattern(param_pattern())->steps[param_step()];
+    step.velocity = value;
+    seq_set_step(param_pattern(), param_step(), step);
+}
+
+static int16_t param_get_velocity(void)
+{
+    return seq_get_pattern(param_pattern())->steps[param_step()].velocity;
+}
+
+static void param_set_length(int16_t value)
+{
+    seq_set_length(param_pattern(), value);
+}
+
+static int16_t param_get_length(void)
+{
+    return seq_get_pattern(param_pattern())->length;
+}
+
+static void param_set_next(int16_t value)
+{
+    seq_set_next(param_pattern(), value - 1);
+}
+
+static int16_t param_get_next(void)
+{
+    return seq_get_pattern(param_pattern())->next + 1;
+}
+
+static void param_set_loop(int16_t value)
+{
+    if (value != REC_STOPPED) pwm_set_mode(PWM_MIDI);
+    recorder_set_state(value);
+    if (value == REC_STOPPED) param_midi_idle();
+}
+
+static int16_t param_get_loop(void) { return recorder_get_state(); }
+static int16_t param_get_events(void) { return recorder_get_count(); }
+
+// 0 leaves clip mode, otherwise the clip played by the trigger button
+static void param_set_clip(int16_t value)
+{
+    if (value == 0 || audio_clip_count() == 0)
+    {
+        if (pwm_get_mode() == PWM_CLIPS) pwm_set_mode(PWM_MANUAL);
+        return;
+    }
+
+    audio_clip_select(value - 1);
+    pwm_set_mode(PWM_CLIPS);
+}
+
+static int16_t param_get_clip(void)
+{
+    return pwm_get_mode() == PWM_CLIPS ? audio_clip_get_selected() + 1 : 0;
+}
+
+static int16_t param_get_clip_count(void) { return audio_clip_count(); }
+
+// Parameter a stored record belongs to, if it still carries flag
+static param_id_t param_record_id(const settings_record_t *record,
+                                  uint8_t flag)
+{
+    char name[sizeof(record->name) + 1] = {0};
+    memcpy(name, record->name, sizeof(record->name));
+
+    param_id_t id = param_find(name);
+    if (id == PARAM_COUNT || !(descs[id].flags & flag)) return PARAM_COUNT;
+    return id;
+}
+
+// Records of the parameters carrying flag, in list order
+static size_t param_records(uint8_t flag, settings_record_t *records)
+{
+    size_t count = 0;
+    for (int id = 0; id < PARAM_COUNT; id++)
+    {
+        if (!(descs[id].flags & flag)) continue;
+        memcpy(records[count].name, descs[id].name, sizeof(records->name));
+        records[count].value = param_get(id);
+        count++;
+    }
+    return count;
+}
+
+static void param_save_preset(int16_t value)
+{
+    if (value == 0) return;
+
+    settings_record_t records[PARAM_COUNT];
+    settings_write(value, records, param_records(PARAM_PRESET, records));
+}
+
+// Applied with the next commit, like values turned by hand
+static void param_load_preset(int16_t value)
+{
+    if (value == 0) return;
+
+    settings_record_t records[SETTINGS_RECORDS];
+    size_t count = settings_read(value, records, SETTINGS_RECORDS);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        param_id_t id = param_record_id(&records[i], PARAM_PRESET);
+        if (id < PARAM_COUNT) param_set(id, records[i].value);
+    }
+}
+
+#define PARAM_DESC(id, name_, type_, min_, max_, default_, slow, fast, unit_, \
+                   flags_, apply_, load_)                                     \
+    [PARAM_##id] = {.name = name_,                                            \
+                    .type = type_,                                            \
+                    .min_value = min_,                                        \
+                    .max_value = max_,                                        \
+                    .default_value = default_,                                \
+                    .steps = {slow, fast},                                    \
+                    .unit = unit_,                                            \
+                    .flags = flags_,                                          \
+                    .apply = apply_,                                          \
+                    .load = load_},
+static const param_desc_t descs[PARAM_COUNT] = {PARAM_LIST(PARAM_DESC)};
+#undef PARAM_DESC
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+void param_init(void)
+{
+    for (int id = 0; id < PARAM_COUNT; id++)
+        values[id] = descs[id].default_value;
+    pending = 0;
+
+    // Restored as is, the engine picks them up once it is running
+    settings_record_t records[SETTINGS_RECORDS];
+    size_t count = settings_read(SETTINGS_CURRENT, records, SETTINGS_RECORDS);
+    for (size_t i = 0; i < count; i++)
+    {
+        param_id_t id = param_record_id(&records[i], PARAM_PERSIST);
+        if (id == PARAM_COUNT) continue;
+
+        int16_t value = records[i].value;
+        if (value < descs[id].min_value) value = descs[id].min_value;
+        if (value > descs[id].max_value) value = descs[id].max_value;
+        values[id] = value;
+    }
+
+    settings_stats_t stats;
+    settings_get_stats(&stats);
+    ESP_LOGI(TAG, "%u settings restored in %lu us", (unsigned)count,
+             stats.read_us);
+}
+
+const param_desc_t *param_desc(param_id_t id) { return &descs[id]; }
+
+param_id_t param_find(const char *name)
+{
+    for (int id = 0; id < PARAM_COUNT; id++)
+        if (strncmp(descs[id].name, name, sizeof(descs[id].name)) == 0)
+            return id;
+    return PARAM_COUNT;
+}
+
+int16_t param_get(param_id_t id)
+{
+    const param_desc_t *desc = &descs[id];
+    if (desc->load && !(pending & (1u << id))) values[id] = desc->load();
+    return values[id];
+}
+
+void param_set(param_id_t id, int32_t value)
+{
+    const param_desc_t *desc = &descs[id];
+    if (desc->type == PARAM_TYPE_STAT) return;
+
+    if (value < desc->min_value)
+        value = desc->min_value;
+    else if (value > desc->max_value)
+        value = desc->max_value;
+
+    values[id] = value;
+    if (!(desc->flags & PARAM_ON_DONE)) pending |= 1u << id;
+}
+
+void param_commit(void)
+{
+    bool output = false;
+    bool persist = false;
+
+    for (int id = 0; pending; id++)
+    {
+        if (!(pending & (1u << id))) continue;
+        pending &= ~(1u << id);
+
+        if (descs[id].apply) descs[id].apply(values[id]);
+        if (descs[id].flags & PARAM_OUTPUT) output = true;
+        if (descs[id].flags & PARAM_PERSIST) persist = true;
+    }
+
+    if (output) param_apply_output();
+    if (persist)
+    {
+        // Written by the store once the values settle
+        settings_record_t records[PARAM_COUNT];
+        settings_stage(records, param_records(PARAM_PERSIST, records));
+    }
+}
+
+void param_done(param_id_t id)
+{
+    if (descs[id].flags & PARAM_ON_DONE) descs[id].apply(values[id]);
+}
+
+// One update for all the manual output settings
+void param_apply_output(void)
+{
+    if (pwm_get_mode() == PWM_MANUAL)
+        pwm_manual_update(values[PARAM_PRF], values[PARAM_PD]);
+    else if (pwm_get_mode() == PWM_AUDIO)
+        // TODO: EDIT THIS
+        audio_set_volume(values[PARAM_PD] * 255 / 100);
+}
+
+int param_format(param_id_t id, char *buf, size_t size)
+{
+    const param_desc_t *desc = &descs[id];
+    int16_t value = param_get(id);
+
+    if (desc->type == PARAM_TYPE_BOOL)
+        return snprintf(buf, size, "%s", value ? "on" : "off");
+    return snprintf(buf, size, "%d%s", value, desc->unit);
+}
@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file param.h
+ * @brief Registry of the user parameters, built from one descriptor list
+ *
+ * Every parameter is one line of PARAM_LIST: its ID, name, type, range,
+ * default, steps, unit, flags and the callbacks that apply it to the engine
+ * and read it back. The IDs, the descriptor table and the menu pages all
+ * come from that list, and the name lookup serves text commands. Lookups by
+ * ID index the table.
+ *
+ * Values set are held until param_commit(), which applies them in one batch:
+ * the manual output settings, flagged PARAM_OUTPUT, reach the output engine
+ * in a single update however many of them changed.
+ *
+ * Parameters flagged PARAM_PERSIST are restored from the settings store by
+ * param_init() and staged there on every commit that changes them. Presets
+ * snapshot the PARAM_PRESET ones, the sequencer settings included even
+ * though the pattern bank keeps those.
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+#ifndef PARAM_H
+#define PARAM_H
+
+// clang-format off
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "recorder.h"
+#include "sdkconfig.h"
+#include "seq.h"
+#include "settings.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define PARAM_PERSIST (1 << 0) // Kept across reboots by the settings store
+#define PARAM_OUTPUT (1 << 1)  // Manual output settings, applied together
+#define PARAM_PRESET (1 << 2)  // Saved and recalled with the presets
+#define PARAM_ON_DONE (1 << 3) // Applied once, when editing ends
+
+// X(id, name, type, min, max, default, slow step, fast step, unit, flags,
+//   apply, load), in menu order. The callbacks are defined in param.c.
+#define PARAM_LIST(X)                                                          \
+    /* Manual mode */                                                          \
+    X(PD, "PD", PARAM_TYPE_INT, 0, CONFIG_INTERRUPT_PD_MAX,                    \
+      CONFIG_INTERRUPT_PD_DEFAULT, 1, 10, "us",                                \
+      PARAM_PERSIST | PARAM_OUTPUT | PARAM_PRESET, NULL, NULL)                 \
+    X(PRF, "PRF", PARAM_TYPE_INT, CONFIG_INTERRUPT_PRF_MIN,                    \
+      CONFIG_INTERRUPT_PRF_MAX, CONFIG_INTERRUPT_PRF_DEFAULT, 1, 100, "Hz",    \
+      PARAM_PERSIST | PARAM_OUTPUT | PARAM_PRESET, NULL, NULL)                 \
+    /* Sequencer */                                                            \
+    X(RUN, "RUN", PARAM_TYPE_BOOL, 0, 1, 0, 1, 1, "", 0, param_seq_run,        \
+      param_seq_running)                                                       \
+    X(BPM, "BPM", PARAM_TYPE_INT, SEQ_BPM_MIN, SEQ_BPM_MAX, 120, 1, 10, "bpm", \
+      PARAM_PRESET, param_set_tempo, param_get_tempo)                          \
+    X(SWG, "SWG", PARAM_TYPE_INT, SEQ_SWING_MIN, SEQ_SWING_MAX, SEQ_SWING_MIN, \
+      1, 5, "%", PARAM_PRESET, param_set_swing, param_get_swing)               \
+    X(ARP, "ARP", PARAM_TYPE_ENUM, SEQ_ARP_OFF, SEQ_ARP_COUNT - 1,             \
+      SEQ_ARP_OFF, 1, 1, "", PARAM_PRESET, param_set_arp, param_get_arp)       \
+    /* Pattern editing */                                                      \
+    X(PAT, "PAT", PARAM_TYPE_INT, 1, SEQ_PATTERNS, 1, 1, 1, "", 0, NULL, NULL) \
+    X(STP, "STP", PARAM_TYPE_INT, 1, SEQ_STEPS, 1, 1, 4, "", 0, NULL, NULL)    \
+    X(NOT, "NOT", PARAM_TYPE_INT, 0, 127, 0, 1, 12, "", 0, param_set_note,     \
+      param_get_note)                                                          \
+    X(VEL, "VEL", PARAM_TYPE_INT, 0, 127, 0, 1, 10, "", 0, param_set_velocity, \
+      param_get_velocity)                                                      \
+    X(LEN, "LEN", PARAM_TYPE_INT, 1, SEQ_STEPS, 1, 1, 4, "", 0,                \
+      param_set_length, param_get_length)                                      \
+    X(NXT, "NXT", PARAM_TYPE_INT, 1, SEQ_PATTERNS, 1, 1, 1, "", 0,             \
+      param_set_next, param_get_next)                                          \
+    /* Loop recorder */                                                        \
+    X(REC, "REC", PARAM_TYPE_ENUM, REC_STOPPED, REC_STATE_COUNT - 1,           \
+      REC_STOPPED, 1, 1, "", 0, param_set_loop, param_get_loop)                \
+    X(EVT, "EVT", PARAM_TYPE_STAT, 0, INT16_MAX, 0, 1, 1, "", 0, NULL,         \
+      param_get_events)                                                        \
+    /* Clip player */                                                          \
+    X(CLP, "CLP", PARAM_TYPE_INT, 0, INT16_MAX, 0, 1, 10, "", 0,               \
+      param_set_clip, param_get_clip)                                          \
+    X(CNT, "CNT", PARAM_TYPE_STAT, 0, INT16_MAX, 0, 1, 1, "", 0, NULL,         \
+      param_get_clip_count)                                                    \
+    /* Presets, 0 does nothing */                                              \
+    X(LD, "LD", PARAM_TYPE_INT, 0, SETTINGS_PRESETS, 0, 1, 1, "",              \
+      PARAM_ON_DONE, param_load_preset, NULL)                                  \
+    X(SV, "SV", PARAM_TYPE_INT, 0, SETTINGS_PRESETS, 0, 1, 1, "",              \
+      PARAM_ON_DONE, param_save_preset, NULL)
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+#define PARAM_ENUM_ID(id, ...) PARAM_##id,
+typedef enum
+{
+    PARAM_LIST(PARAM_ENUM_ID)
+    PARAM_COUNT
+} param_id_t;
+#undef PARAM_ENUM_ID
+
+typedef enum
+{
+    PARAM_TYPE_INT,
+    PARAM_TYPE_BOOL,
+    PARAM_TYPE_ENUM, // Index into a list of modes
+    PARAM_TYPE_STAT, // Read only
+} param_type_t;
+
+typedef struct
+{
+    char name[4];
+    param_type_t type;
+    int16_t min_value;
+    int16_t max_value;
+    int16_t default_value;
+    uint16_t steps[2]; // Turning slowly, turning fast
+    const char *unit;
+    uint8_t flags;
+    void (*apply)(int16_t value); // Output settings have none
+    int16_t (*load)(void);        // Current value, read before display
+} param_desc_t;
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+// Defaults, then the stored settings, before anything shows them
+void param_init(void);
+
+const param_desc_t *param_desc(param_id_t id);
+
+// PARAM_COUNT when no parameter has that name
+param_id_t param_find(const char *name);
+
+// Loaded from the engine unless a set is waiting for the commit
+int16_t param_get(param_id_t id);
+
+// Clamped to the range, read only parameters are left alone
+void param_set(param_id_t id, int32_t value);
+
+// Applies everything set since the last commit
+void param_commit(void);
+
+// Editing of id ended
+void param_done(param_id_t id);
+
+// Pushes the manual output settings, once the output is up
+void param_apply_output(void);
+
+// Value and unit, as text
+int param_format(param_id_t id, char *buf, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
+
+#endif /* !PARAM_H */
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file patch.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "patch.h"
+#include "bank.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "esp_timer.h"
+#include "sdkconfig.h"
+#include "voice.h"
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define PARTITION_LABEL CONFIG_INTERRUPT_PATCH_PARTITION
+#define PATCH_CACHE CONFIG_INTERRUPT_PATCH_CACHE
+
+#define TAG "patch"
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static voice_patch_t cache[PATCH_CACHE];
+static char names[PATCH_CACHE][BANK_NAME_LEN + 1];
+static uint8_t count = 0;
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+// Call after the voice engine is initialized, the patches use its rate
+esp_err_t patch_init(void)
+{
+    const esp_partition_t *part = esp_partition_find_first(
+        ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, PARTITION_LABEL);
+    if (part == NULL)
+    {
+        ESP_LOGW(TAG, "No '%s' partition", PARTITION_LABEL);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    int64_t t0 = esp_timer_get_time();
+
+    // Only mapped while compiling, the cache is all that is used afterwards
+    const void *ptr;
+    esp_partition_mmap_handle_t mmap;
+    esp_err_t err = esp_partition_mmap(part, 0, part->size,
+                                       ESP_PARTITION_MMAP_DATA, &ptr, &mmap);
+    if (err != ESP_OK) return err;
+
+    uint16_t preset_count;
+    const bank_preset_t *presets = bank_open(ptr, part->size, &preset_count);
+    if (presets == NULL)
+    {
+        esp_partition_munmap(mmap);
+        ESP_LOGW(TAG, "No preset bank in '%s'", PARTITION_LABEL);
+        return ESP_ERR_INVALID_VERSION;
+    }
+
+    if (preset_count > PATCH_CACHE)
+    {
+        ESP_LOGW(TAG, "%d presets, only the first %d are cached", preset_count,
+                 PATCH_CACHE);
+        preset_count = PATCH_CACHE;
+    }
+
+    for (int i = 0; i < preset_count; i++)
+    {
+        voice_patch_compile(&cache[i], &presets[i]);
+        memcpy(names[i], presets[i].name, BANK_NAME_LEN);
+        names[i][BANK_NAME_LEN] = '\0';
+    }
+    count = preset_count;
+    esp_partition_munmap(mmap);
+
+    voice_set_patches(cache, count);
+    voice_select_patch(0);
+
+    ESP_LOGI(TAG, "%d presets cached in %lld us, program 0: %s", count,
+             esp_timer_get_time() - t0, names[0]);
+
+    return ESP_OK;
+}
+
+uint8_t patch_get_count(void) { return count; }
+
+const char *patch_get_name(uint8_t program)
+{
+    return program < count ? names[program] : NULL;
+}
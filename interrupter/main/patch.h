@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file patch.h
+ * @brief Program change mapped voice presets
+ *
+ * The preset bank image (see bank.h, built by tools/mkbank) is read from a
+ * flash partition at boot and every preset is compiled into a RAM cache of
+ * voice patches. Program change then selects a patch in the voice engine
+ * by index, without flash access, allocation or floating point.
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+#ifndef PATCH_H
+#define PATCH_H
+
+// clang-format off
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "esp_err.h"
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+esp_err_t patch_init(void);
+uint8_t patch_get_count(void);
+const char *patch_get_name(uint8_t program);
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
+
+#endif /* !PATCH_H */
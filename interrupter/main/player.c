@@ -0,0 +1,191 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file player.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "player.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "esp_timer.h"
+#include "midi.h"
+#include "sdkconfig.h"
+#include "smf.h"
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define PARTITION_LABEL CONFIG_INTERRUPT_SMF_PARTITION
+#define CC_ALL_NOTES_OFF 123
+
+#define TAG "player"
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static const uint8_t *part_data = NULL;
+static size_t part_size = 0;
+static esp_partition_mmap_handle_t part_mmap;
+
+static esp_timer_handle_t play_timer = NULL;
+static smf_t smf;
+static smf_event_t pending;
+static bool has_pending = false;
+static int64_t start_us = 0;
+static volatile bool playing = false;
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static void play_timer_cb(void *arg)
+{
+    if (!playing) return;
+
+    int64_t now = esp_timer_get_time() - start_us;
+    while (has_pending && (int64_t)pending.time_us <= now)
+    {
+        midi_post(MIDI_SOURCE_PLAYER, &pending.msg,
+                  start_us + (int64_t)pending.time_us);
+        has_pending = smf_next(&smf, &pending);
+    }
+
+    if (!has_pending)
+    {
+#if CONFIG_INTERRUPT_SMF_LOOP
+        smf_rewind(&smf);
+        start_us = esp_timer_get_time();
+        now = 0;
+        has_pending = smf_next(&smf, &pending);
+#endif
+        if (!has_pending)
+        {
+            ESP_LOGI(TAG, "End of file");
+            playing = false;
+            return;
+        }
+    }
+
+    // Sleep until the next event, nothing runs in between
+    esp_timer_start_once(play_timer, pending.time_us - now);
+}
+
+// Locate a file in the partition, files are stored back to back. Opened in
+// the given parser, the one playing is never touched by a lookup.
+static size_t player_find(smf_t *parser, uint8_t index, const uint8_t **data)
+{
+    size_t offset = 0;
+
+    for (uint8_t i = 0; offset < part_size; i++)
+    {
+        size_t len =
+            smf_open(parser, part_data + offset, part_size - offset);
+        if (len == 0) return 0;
+        if (i == index)
+        {
+            *data = part_data + offset;
+            return len;
+        }
+        offset += len;
+    }
+
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+esp_err_t player_init(void)
+{
+    const esp_partition_t *part = esp_partition_find_first(
+        ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, PARTITION_LABEL);
+    if (part == NULL)
+    {
+        ESP_LOGW(TAG, "No '%s' partition", PARTITION_LABEL);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    // Mapped once, files are then parsed in place without any copy
+    const void *ptr;
+    ESP_ERROR_CHECK(esp_partition_mmap(part, 0, part->size,
+                                       ESP_PARTITION_MMAP_DATA, &ptr,
+                                       &part_mmap));
+    part_data = ptr;
+    part_size = part->size;
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = play_timer_cb,
+        .name = "smf_player",
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&timer_args, &play_timer));
+
+    ESP_LOGI(TAG, "%d file(s) in '%s'", player_get_file_count(),
+             PARTITION_LABEL);
+
+    return ESP_OK;
+}
+
+uint8_t player_get_file_count(void)
+{
+    smf_t parser;
+    uint8_t count = 0;
+    const uint8_t *data;
+
+    while (count < UINT8_MAX && player_find(&parser, count, &data) > 0)
+        count++;
+
+    return count;
+}
+
+esp_err_t player_play(uint8_t index)
+{
+    if (part_data == NULL) return ESP_ERR_INVALID_STATE;
+
+    player_stop();
+
+    int64_t t0 = esp_timer_get_time();
+
+    const uint8_t *data;
+    size_t len = player_find(&smf, index, &data);
+    if (len == 0) return ESP_ERR_NOT_FOUND;
+
+    smf_open(&smf, data, len);
+    has_pending = smf_next(&smf, &pending);
+    if (!has_pending) return ESP_ERR_INVALID_SIZE;
+
+    start_us = esp_timer_get_time();
+    playing = true;
+    play_timer_cb(NULL);
+
+    ESP_LOGI(TAG, "Playing file %d (%d tracks), started in %lld us", index,
+             smf.track_count, esp_timer_get_time() - t0);
+
+    return ESP_OK;
+}
+
+void player_stop(void)
+{
+    if (!playing) return;
+
+    playing = false;
+    esp_timer_stop(play_timer);
+
+    midi_message_t msg = {
+        .type = MIDI_MSG_CONTROL_CHANGE,
+        .note = CC_ALL_NOTES_OFF,
+    };
+    midi_post(MIDI_SOURCE_PLAYER, &msg, esp_timer_get_time());
+}
+
+bool player_is_playing(void) { return playing; }
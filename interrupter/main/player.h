@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file player.h
+ * @brief Standard MIDI File player streaming from a flash partition
+ *
+ * The partition holds one or more .mid files back to back. It is
+ * memory-mapped once and parsed in place, events are posted through
+ * midi_post() like the USB ones.
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+#ifndef PLAYER_H
+#define PLAYER_H
+
+// clang-format off
+#ifdef __cplusplus
+extern "C" 
+{
+#endif
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+esp_err_t player_init(void);
+uint8_t player_get_file_count(void);
+esp_err_t player_play(uint8_t index);
+void player_stop(void);
+bool player_is_playing(void);
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
+
+#endif /* !PLAYER_H */
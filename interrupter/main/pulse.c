@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file pulse.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "pulse.h"
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+void pulse_sched_reset(pulse_sched_t *sched)
+{
+    memset(sched, 0, sizeof(*sched));
+}
+
+// One pulse timer alarm. Returns the width of the pulse to fire now (0 for
+// none) and the ticks until the next alarm.
+uint16_t IRAM_ATTR pulse_sched_alarm(pulse_sched_t *sched, uint32_t now_tick,
+                                     pulse_source_t source,
+                                     uint32_t *alarm_in)
+{
+    uint32_t now_q8 = now_tick << VOICE_PERIOD_SHIFT;
+    uint16_t fire = sched->pending.width_tick;
+
+    if (fire > 0)
+        sched->end_q8 = now_q8 + ((uint32_t)fire << VOICE_PERIOD_SHIFT);
+
+    *alarm_in = PULSE_IDLE_POLL;
+    if (source(now_q8, &sched->pending))
+    {
+        // Pulses of different voices never overlap, keep a minimum off time
+        uint32_t earliest = sched->end_q8 + PULSE_MIN_OFF_Q8;
+        if ((int32_t)(sched->pending.at_q8 - earliest) < 0)
+            sched->pending.at_q8 = earliest;
+
+        int32_t in = (int32_t)(sched->pending.at_q8 - now_q8) >>
+                     VOICE_PERIOD_SHIFT;
+        if (in < PULSE_ALARM_MARGIN) in = PULSE_ALARM_MARGIN;
+        *alarm_in = in;
+    }
+    else
+    {
+        sched->pending.width_tick = 0;
+    }
+
+    return fire;
+}
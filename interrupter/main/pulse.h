@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file pulse.h
+ * @brief Output stage logic shared by the firmware and the host tools
+ *
+ * The pulse timer scheduling of MIDI mode and the sample to duty mapping
+ * of the audio modes, without any peripheral access. pwm.c and audio.c
+ * drive the RMT and LEDC with them, tools/sim and tools/pulsetl drive a
+ * virtual clock, so both see the same pulse train.
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+#ifndef PULSE_H
+#define PULSE_H
+
+// clang-format off
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "sdkconfig.h"
+#include "voice.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define PULSE_MIN_OFF_Q8 (CONFIG_INTERRUPT_MIN_OFF_US << VOICE_PERIOD_SHIFT)
+#define PULSE_ALARM_MARGIN 5 // ticks, covers the ISR entry latency
+#define PULSE_IDLE_POLL (VOICE_TICK_HZ / CONFIG_INTERRUPT_CONTROL_RATE_HZ)
+
+#define PULSE_SAMPLE_MAX 2047 // Audio samples are signed 12 bits
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+// Next pulse of MIDI mode, called from the pulse timer ISR
+typedef bool (*pulse_source_t)(uint32_t now_q8, voice_pulse_t *pulse);
+
+typedef struct
+{
+    voice_pulse_t pending; // Fired at the next alarm when width_tick > 0
+    uint32_t end_q8;       // End of the last pulse fired
+} pulse_sched_t;
+
+// -----------------------------------------------------------------------------
+// Inline Function Definitions
+// -----------------------------------------------------------------------------
+// 8 bit LEDC duty of a signed 12 bit sample
+static inline uint8_t pulse_duty(int32_t sample)
+{
+    int mapped_val = (sample + PULSE_SAMPLE_MAX + 1) * 255 / 4095;
+    if (mapped_val < 0) mapped_val = 0;
+    if (mapped_val > 255) mapped_val = 255;
+    return mapped_val;
+}
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+void pulse_sched_reset(pulse_sched_t *sched);
+uint16_t pulse_sched_alarm(pulse_sched_t *sched, uint32_t now_tick,
+                           pulse_source_t source, uint32_t *alarm_in);
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
+
+#endif /* !PULSE_H */
@@ -18,37 +18,35 @@
 // -----------------------------------------------------------------------------
 #include "pwm.h"
 #include "audio.h"
-#include "driver/ledc.h"
-#include "driver/rmt.h"
-#include "rom/gpio.h"
+#include "driver/gptimer.h"
+#include "esp_attr.h"
+#include "freertos/FreeRTOS.h"
+#include "mode_switch.h"
+#include "output.h"
+#include "pulse.h"
 #include "sdkconfig.h"
-#include "soc/gpio_reg.h"
-#include "soc/gpio_sig_map.h"
+#include "synth.h"
+#include "tasks.h"
+#include "voice.h"
 
 // -----------------------------------------------------------------------------
 // Macros and Constants
 // -----------------------------------------------------------------------------
-#define PIN_OUTPUT CONFIG_INTERRUPT_PIN_OUTPUT
-
-#define RMT_CHANNEL RMT_CHANNEL_0
-#define RMT_CLK_DIV 80 // 80 MHz / 80 = 1 MHz → 1 tick = 1 us
-#define RMT_TICK_US (80 / RMT_CLK_DIV)
-
-#define LEDC_TIMER LEDC_TIMER_0
-#define LEDC_MODE LEDC_LOW_SPEED_MODE
-#define LEDC_CHANNEL LEDC_CHANNEL_0
-#define LEDC_DUTY_RES LEDC_TIMER_8_BIT
-#define LEDC_FREQUENCY (30e3)
+#define PULSE_TIMER_HZ OUTPUT_TICK_HZ
+#define TICKS_PER_US (OUTPUT_TICK_HZ / 1000000)
 
 #define TAG "pwm"
 
 // -----------------------------------------------------------------------------
 // Static Variables
 // -----------------------------------------------------------------------------
-static pwm_mode_t mode = PWM_MANUAL;
+static mode_switch_t modes;
 static QueueHandle_t lpwm_task_queue = NULL;
 static TaskHandle_t lpwm_task_handle = NULL;
-static bool armed = false;
+
+static gptimer_handle_t pulse_timer = NULL;
+static volatile pwm_pulse_source_t pulse_source = voice_next_pulse;
+static pulse_sched_t pulse_sched;
 
 // -----------------------------------------------------------------------------
 // Static Function Declarations
@@ -75,10 +73,7 @@ static void lpwm_task(void *pvParams)
         // If period or pulse_width is zero, block until valid value arrives
         while (period_tick == 0 || pulse_width_tick == 0)
         {
-            // Ensure output pin is low
-            WRITE_PERI_REG(GPIO_OUT_W1TC_REG, (1ULL << PIN_OUTPUT));
-
-            // Wait for new PWM data
+            // Wait for new PWM data, the output idles low between pulses
             if (xQueueReceive(lpwm_task_queue, &pwm_data, portMAX_DELAY) ==
                 pdPASS)
             {
@@ -87,141 +82,154 @@ static void lpwm_task(void *pvParams)
             }
         }
 
-        rmt_item32_t item;
-        item.level0 = 1;
-        item.duration0 = pulse_width_tick; // high time
-        item.level1 = 0;
-        item.duration1 = pulse_width_tick; // low time
-
-        rmt_write_items(RMT_CHANNEL, &item, 1, false);
-        vTaskDelay(pdMS_TO_TICKS((period_tick * RMT_TICK_US) / 1000));
+        output_pulse(pulse_width_tick);
+        vTaskDelay(pdMS_TO_TICKS(period_tick / TICKS_PER_US / 1000));
     }
 }
 
-static void pwm_ledc_set_duty(uint8_t duty)
+static bool IRAM_ATTR pulse_timer_cb(gptimer_handle_t timer,
+                                     const gptimer_alarm_event_data_t *edata,
+                                     void *user_ctx)
 {
-    // if (duty > 512) duty = 512;
-    ESP_ERROR_CHECK(ledc_set_duty(LEDC_MODE, LEDC_CHANNEL, duty));
-    ESP_ERROR_CHECK(ledc_update_duty(LEDC_MODE, LEDC_CHANNEL));
-}
+    uint64_t count;
+    gptimer_get_raw_count(timer, &count);
 
-// -----------------------------------------------------------------------------
-// Function Definitions
-// -----------------------------------------------------------------------------
-void pwm_init(void)
-{
-    lpwm_task_queue = xQueueCreate(2, sizeof(uint32_t[2]));
+    // A pending pulse goes out now, how long after it was due
+    if (pulse_sched.pending.width_tick > 0)
+    {
+        int32_t late_q8 = (int32_t)(((uint32_t)count << VOICE_PERIOD_SHIFT) -
+                                    pulse_sched.pending.at_q8);
+        if (late_q8 < 0) late_q8 = 0;
+        task_late(TASK_OUTPUT, (late_q8 >> VOICE_PERIOD_SHIFT) / TICKS_PER_US);
+    }
 
-    ledc_channel_config_t ledc_channel = {.speed_mode = LEDC_MODE,
-                                          .channel = LEDC_CHANNEL,
-                                          .timer_sel = LEDC_TIMER,
-                                          .intr_type = LEDC_INTR_DISABLE,
-                                          .gpio_num = PIN_OUTPUT,
-                                          .duty = 0,
-                                          .hpoint = 0};
-    ESP_ERROR_CHECK(ledc_channel_config(&ledc_channel));
-
-    rmt_config_t config = {
-        .rmt_mode = RMT_MODE_TX,
-        .channel = RMT_CHANNEL,
-        .gpio_num = PIN_OUTPUT,
-        .clk_div = RMT_CLK_DIV,
-        .mem_block_num = 1,
-        .tx_config.loop_en = true,
-        .tx_config.carrier_en = false,
-    };
-    rmt_config(&config);
-    rmt_driver_install(config.channel, 0, 0);
+    uint32_t in;
+    uint16_t width =
+        pulse_sched_alarm(&pulse_sched, (uint32_t)count, pulse_source, &in);
+    if (width > 0) output_pulse(width);
 
-    xTaskCreate(lpwm_task, "low_pwm_task", 1024, NULL, 2, &lpwm_task_handle);
+    gptimer_alarm_config_t alarm_config = {.alarm_count = count + in};
+    gptimer_set_alarm_action(timer, &alarm_config);
 
-    audio_init();
-    audio_set_pwm_duty_update_cb(pwm_ledc_set_duty);
-    // Prepare and then apply the LEDC PWM timer configuration
-    ledc_timer_config_t ledc_timer = {.speed_mode = LEDC_MODE,
-                                      .duty_resolution = LEDC_DUTY_RES,
-                                      .timer_num = LEDC_TIMER,
-                                      .freq_hz = LEDC_FREQUENCY,
-                                      .clk_cfg = LEDC_AUTO_CLK};
-    ESP_ERROR_CHECK(ledc_timer_config(&ledc_timer));
-
-    pwm_disarm();
+    return false;
 }
 
-void pwm_arm(void)
+static void pwm_mode_leave(pwm_mode_t mode, void *ctx)
 {
-    armed = true;
+    (void)ctx;
     if (mode == PWM_MANUAL)
     {
-        gpio_matrix_out(PIN_OUTPUT, RMT_SIG_OUT0_IDX, 0, 0);
+        vTaskSuspend(lpwm_task_handle);
     }
-    else if (mode == PWM_AUDIO)
+    else if (mode == PWM_AUDIO || mode == PWM_CLIPS)
     {
-        gpio_matrix_out(PIN_OUTPUT, LEDC_LS_SIG_OUT0_IDX, 0, 0);
+        audio_stop();
+    }
+    else if (mode == PWM_MIDI)
+    {
+        gptimer_stop(pulse_timer);
+        synth_stop();
     }
 }
 
-void pwm_disarm(void)
+static void pwm_mode_enter(pwm_mode_t mode, void *ctx)
 {
-    armed = false;
-    gpio_matrix_out(PIN_OUTPUT, SIG_GPIO_OUT_IDX, 0, 0);
+    (void)ctx;
+    if (mode == PWM_MANUAL)
+    {
+        vTaskResume(lpwm_task_handle);
+    }
+    else if (mode == PWM_AUDIO)
+    {
+        audio_listen();
+    }
+    else if (mode == PWM_CLIPS)
+    {
+        audio_play_clips();
+    }
+    else if (mode == PWM_MIDI)
+    {
+        pulse_sched_reset(&pulse_sched);
+        synth_start();
+
+        gptimer_set_raw_count(pulse_timer, 0);
+        gptimer_alarm_config_t alarm_config = {.alarm_count = PULSE_IDLE_POLL};
+        gptimer_set_alarm_action(pulse_timer, &alarm_config);
+        gptimer_start(pulse_timer);
+    }
 }
 
-void pwm_set_mode(pwm_mode_t pwm_mode)
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+void pwm_init(void)
 {
-    if (pwm_mode == PWM_AUDIO)
-    {
-        if (mode == PWM_AUDIO) return;
+    lpwm_task_queue = xQueueCreate(2, sizeof(uint32_t[2]));
 
-        // Stop MANUAL
-        vTaskSuspend(lpwm_task_handle);
-        rmt_tx_stop(RMT_CHANNEL);
-        WRITE_PERI_REG(GPIO_OUT_W1TC_REG, (1ULL << PIN_OUTPUT));
+    // Audio and clip modes need the LEDC backend
+    output_rmt.init();
+#if CONFIG_INTERRUPT_OUTPUT_LEDC
+    output_ledc.init();
+    const output_backend_t *duty_backend = &output_ledc;
+#else
+    const output_backend_t *duty_backend = NULL;
+#endif
+    const mode_switch_hooks_t hooks = {
+        .leave = pwm_mode_leave,
+        .enter = pwm_mode_enter,
+    };
+    mode_switch_init(&modes, PWM_MANUAL, &output_rmt, duty_backend, &hooks);
 
-        // Start AUDIO
-        if (armed) gpio_matrix_out(PIN_OUTPUT, LEDC_LS_SIG_OUT0_IDX, 0, 0);
-        audio_listen();
-    }
-    else if (pwm_mode == PWM_MANUAL)
-    {
-        if (mode == PWM_MANUAL) return;
+    lpwm_task_handle = task_start(TASK_OUTPUT, lpwm_task, NULL);
 
-        // Stop AUDIO
-        audio_stop();
-        ledc_stop(LEDC_MODE, LEDC_CHANNEL_0, 0);
-        WRITE_PERI_REG(GPIO_OUT_W1TC_REG, (1ULL << PIN_OUTPUT));
+    gptimer_config_t timer_config = {
+        .clk_src = GPTIMER_CLK_SRC_DEFAULT,
+        .direction = GPTIMER_COUNT_UP,
+        .resolution_hz = PULSE_TIMER_HZ,
+    };
+    ESP_ERROR_CHECK(gptimer_new_timer(&timer_config, &pulse_timer));
+    gptimer_event_callbacks_t timer_cbs = {.on_alarm = pulse_timer_cb};
+    ESP_ERROR_CHECK(
+        gptimer_register_event_callbacks(pulse_timer, &timer_cbs, NULL));
+    ESP_ERROR_CHECK(gptimer_enable(pulse_timer));
 
-        // Start MANUAL
-        if (armed) gpio_matrix_out(PIN_OUTPUT, RMT_SIG_OUT0_IDX, 0, 0);
-        vTaskResume(lpwm_task_handle);
-    }
+    synth_init();
 
-    mode = pwm_mode;
+#if CONFIG_INTERRUPT_OUTPUT_LEDC
+    audio_init();
+    audio_set_pwm_duty_update_cb(output_duty);
+#endif
 }
 
-pwm_mode_t pwm_get_mode(void) { return mode; }
+void pwm_arm(void) { output_arm(); }
+
+void pwm_disarm(void) { output_disarm(); }
+
+void pwm_set_mode(pwm_mode_t pwm_mode) { mode_switch_set(&modes, pwm_mode); }
+
+pwm_mode_t pwm_get_mode(void) { return modes.mode; }
 
 void pwm_manual_update(uint16_t freq_hz, uint16_t pulse_width_us)
 {
-    if (mode != PWM_MANUAL) return;
+    if (modes.mode != PWM_MANUAL) return;
 
     uint32_t pwm_data[2] = {0};
     if (freq_hz == 0 || pulse_width_us == 0)
     {
         // Stop output
-        rmt_tx_stop(RMT_CHANNEL);
+        output_train(0, 0);
         xQueueSend(lpwm_task_queue, pwm_data, 0);
-        WRITE_PERI_REG(GPIO_OUT_W1TC_REG, (1ULL << PIN_OUTPUT));
         return;
     }
 
-    uint32_t period_tick = 1000000UL / (freq_hz * RMT_TICK_US);
-    uint32_t pulse_width_tick = pulse_width_us / RMT_TICK_US;
+    uint32_t period_tick = OUTPUT_TICK_HZ / freq_hz;
+    uint32_t pulse_width_tick = pulse_width_us * TICKS_PER_US;
     if (pulse_width_tick > period_tick / 2) pulse_width_tick = period_tick / 2;
 
-    if (period_tick > 32767) // rmt_item32_t.duration0/1 overflow
+    if (period_tick > output_train_max())
     {
-        rmt_set_tx_loop_mode(RMT_CHANNEL, false);
+        // Too slow for the peripheral, pulses are timed by the task
+        output_train(0, 0);
         pwm_data[0] = period_tick;
         pwm_data[1] = pulse_width_tick;
 
@@ -230,14 +238,11 @@ void pwm_manual_update(uint16_t freq_hz, uint16_t pulse_width_us)
     else
     {
         xQueueSend(lpwm_task_queue, pwm_data, 0);
-        rmt_set_tx_loop_mode(RMT_CHANNEL, true);
-
-        rmt_item32_t item;
-        item.level0 = 1;
-        item.duration0 = pulse_width_tick; // high time
-        item.level1 = 0;
-        item.duration1 = period_tick - pulse_width_tick; // low time
-
-        rmt_write_items(RMT_CHANNEL, &item, 1, false);
+        output_train(period_tick, pulse_width_tick);
     }
 }
+
+void pwm_set_pulse_source(pwm_pulse_source_t source)
+{
+    pulse_source = source ? source : voice_next_pulse;
+}
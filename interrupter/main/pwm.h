@@ -19,7 +19,10 @@
 #define PWM_H
 
 // clang-format off
+#include <stdbool.h>
 #include <stdint.h>
+#include "pulse.h"
+#include "voice.h"
 #ifdef __cplusplus
 extern "C" 
 {
@@ -38,9 +41,14 @@ extern "C"
 // -----------------------------------------------------------------------------
 typedef enum {
     PWM_MANUAL,
-    PWM_AUDIO
+    PWM_AUDIO,
+    PWM_MIDI,
+    PWM_CLIPS
 } pwm_mode_t;
 
+// Called from the pulse timer ISR for the next pulse of MIDI mode
+typedef pulse_source_t pwm_pulse_source_t;
+
 // -----------------------------------------------------------------------------
 // Inline Function Definitions
 // -----------------------------------------------------------------------------
@@ -52,6 +60,7 @@ void pwm_init(void);
 void pwm_set_mode(pwm_mode_t mode);
 pwm_mode_t pwm_get_mode(void);
 void pwm_manual_update(uint16_t freq_hz, uint16_t pulse_width_us);
+void pwm_set_pulse_source(pwm_pulse_source_t source);
 void pwm_arm(void);
 void pwm_disarm(void);
 
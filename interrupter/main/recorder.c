@@ -0,0 +1,303 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file recorder.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "recorder.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "midi_parse.h"
+#include "sdkconfig.h"
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define REC_EVENTS CONFIG_INTERRUPT_REC_EVENTS
+#define CC_ALL_NOTES_OFF 123
+
+#define TAG "recorder"
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t time_us; // Offset in the loop
+    uint8_t bytes[3];
+    uint8_t reserved;
+} rec_event_t;
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static rec_event_t events[REC_EVENTS];
+static uint32_t head = 0;
+static uint32_t tail = 0;
+static uint32_t count = 0;
+static uint32_t dropped = 0;
+
+static volatile rec_state_t state = REC_STOPPED;
+static int64_t pass_start_us = 0;
+static uint32_t pass_left = 0; // Records of the current pass not played yet
+static uint32_t loop_us = 0;
+
+// Notes held while recording, released at the end of the take
+static uint32_t held[16][4];
+
+static esp_timer_handle_t rec_timer = NULL;
+static portMUX_TYPE rec_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+// Ring operations, called under rec_lock
+static bool rec_push(const rec_event_t *event)
+{
+    if (count == REC_EVENTS)
+    {
+        dropped++;
+        return false;
+    }
+
+    events[head] = *event;
+    head = head + 1 == REC_EVENTS ? 0 : head + 1;
+    count++;
+    return true;
+}
+
+static rec_event_t rec_pop(void)
+{
+    rec_event_t event = events[tail];
+    tail = tail + 1 == REC_EVENTS ? 0 : tail + 1;
+    count--;
+    return event;
+}
+
+static void rec_track_note(const uint8_t bytes[3])
+{
+    uint8_t channel = bytes[0] & 0x0F;
+    uint32_t bit = 1UL << (bytes[1] & 31);
+
+    if ((bytes[0] & 0xF0) == 0x90 && bytes[2] > 0)
+        held[channel][bytes[1] >> 5] |= bit;
+    else if ((bytes[0] & 0xF0) == 0x80 || (bytes[0] & 0xF0) == 0x90)
+        held[channel][bytes[1] >> 5] &= ~bit;
+}
+
+// Close the notes still held so they do not hang over the loop
+static void rec_release_held(uint32_t time_us)
+{
+    for (int ch = 0; ch < 16; ch++)
+    {
+        for (int w = 0; w < 4; w++)
+        {
+            while (held[ch][w])
+            {
+                int bit = __builtin_ctz(held[ch][w]);
+                held[ch][w] &= ~(1UL << bit);
+                rec_event_t event = {
+                    .time_us = time_us,
+                    .bytes = {0x80 | ch, w * 32 + bit, 0},
+                };
+                rec_push(&event);
+            }
+        }
+    }
+}
+
+// Cycle the rest of the pass so the ring starts at the loop start again
+static void rec_rewind(void)
+{
+    while (pass_left > 0)
+    {
+        rec_event_t event = rec_pop();
+        rec_push(&event);
+        pass_left--;
+    }
+}
+
+static void rec_timer_cb(void *arg)
+{
+    while (1)
+    {
+        rec_event_t event;
+        int64_t event_us = 0;
+        int64_t wait = 0;
+
+        portENTER_CRITICAL(&rec_lock);
+        if (state < REC_PLAYING)
+        {
+            portEXIT_CRITICAL(&rec_lock);
+            return;
+        }
+
+        int64_t offset = esp_timer_get_time() - pass_start_us;
+        if (pass_left == 0 && offset >= loop_us)
+        {
+            pass_start_us += loop_us;
+            offset -= loop_us;
+            pass_left = count;
+        }
+
+        if (pass_left > 0 && events[tail].time_us <= offset)
+        {
+            // Played records go back at the head for the next pass
+            event = rec_pop();
+            rec_push(&event);
+            pass_left--;
+            event_us = pass_start_us + event.time_us;
+        }
+        else
+        {
+            wait = (pass_left > 0 ? events[tail].time_us : loop_us) - offset;
+        }
+        portEXIT_CRITICAL(&rec_lock);
+
+        if (wait > 0)
+        {
+            // Sleep until the next record or the end of the pass
+            esp_timer_start_once(rec_timer, wait);
+            return;
+        }
+
+        midi_message_t msg;
+        if (midi_decode(event.bytes[0], event.bytes[1], event.bytes[2], &msg))
+            midi_post(MIDI_SOURCE_RECORDER, &msg, event_us);
+    }
+}
+
+static void rec_all_notes_off(void)
+{
+    midi_message_t msg = {
+        .type = MIDI_MSG_CONTROL_CHANGE,
+        .note = CC_ALL_NOTES_OFF,
+    };
+    midi_post(MIDI_SOURCE_RECORDER, &msg, esp_timer_get_time());
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+esp_err_t recorder_init(void)
+{
+    const esp_timer_create_args_t timer_args = {
+        .callback = rec_timer_cb,
+        .name = "recorder",
+    };
+    esp_err_t err = esp_timer_create(&timer_args, &rec_timer);
+    if (err != ESP_OK) return err;
+
+    ESP_LOGI(TAG, "%d events (%d bytes)", REC_EVENTS, (int)sizeof(events));
+
+    return ESP_OK;
+}
+
+void recorder_set_state(rec_state_t new_state)
+{
+    if (new_state >= REC_STATE_COUNT || new_state == state) return;
+
+    int64_t now = esp_timer_get_time();
+    rec_state_t old_state = state;
+    bool playing = false;
+
+    esp_timer_stop(rec_timer);
+
+    portENTER_CRITICAL(&rec_lock);
+    uint32_t offset = now - pass_start_us;
+    if (old_state == REC_RECORDING)
+    {
+        // End of the take, it sets the loop length
+        loop_us = offset > 0 ? offset : 1;
+        rec_release_held(loop_us);
+    }
+    else if (old_state == REC_OVERDUB)
+    {
+        rec_release_held(offset);
+    }
+
+    if (new_state == REC_RECORDING)
+    {
+        head = tail = count = dropped = 0;
+        pass_left = 0;
+        loop_us = 0;
+        memset(held, 0, sizeof(held));
+        pass_start_us = now;
+    }
+    else if (new_state == REC_STOPPED)
+    {
+        rec_rewind();
+    }
+    else if (old_state == REC_STOPPED || old_state == REC_RECORDING)
+    {
+        // Playback starts a new pass right away
+        playing = loop_us > 0;
+        pass_start_us = now;
+        pass_left = count;
+    }
+    else
+    {
+        // Between playing and overdub, the pass goes on
+        playing = true;
+    }
+
+    if (new_state >= REC_PLAYING && !playing)
+        new_state = REC_STOPPED; // Nothing recorded yet
+    state = new_state;
+    portEXIT_CRITICAL(&rec_lock);
+
+    if (old_state >= REC_PLAYING && new_state < REC_PLAYING)
+        rec_all_notes_off();
+    if (playing) rec_timer_cb(NULL);
+
+    ESP_LOGI(TAG, "State %d, %lu events in %lu ms, %lu dropped", new_state,
+             count, loop_us / 1000, dropped);
+}
+
+rec_state_t recorder_get_state(void) { return state; }
+
+void recorder_clear(void)
+{
+    recorder_set_state(REC_STOPPED);
+
+    portENTER_CRITICAL(&rec_lock);
+    head = tail = count = dropped = 0;
+    loop_us = 0;
+    portEXIT_CRITICAL(&rec_lock);
+}
+
+uint32_t recorder_get_count(void) { return count; }
+
+void recorder_append(const midi_message_t *msg, int64_t time_us)
+{
+    // Single read while idle, live input is not slowed down
+    if (state != REC_RECORDING && state != REC_OVERDUB) return;
+
+    rec_event_t event = {0};
+    if (!midi_encode(msg, event.bytes)) return;
+
+    portENTER_CRITICAL(&rec_lock);
+    if (state == REC_RECORDING || state == REC_OVERDUB)
+    {
+        int64_t offset = time_us - pass_start_us;
+        if (offset < 0) offset = 0;
+        if (state == REC_OVERDUB && offset >= loop_us) offset -= loop_us;
+        event.time_us = offset;
+        if (rec_push(&event)) rec_track_note(event.bytes);
+    }
+    portEXIT_CRITICAL(&rec_lock);
+}
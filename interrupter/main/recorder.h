@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file recorder.h
+ * @brief MIDI loop recorder
+ *
+ * Live events are stored as 8 byte records (offset in the loop and the
+ * three MIDI bytes) in a statically allocated ring. The loop works like a
+ * tape: playback pops each record from the tail as it becomes due, posts
+ * it and appends it back at the head, where overdubbed live events are
+ * appended too, so the ring always holds the next pass in time order and
+ * every operation is O(1). Nothing runs while idle, playback sleeps on a
+ * one-shot timer until the next record.
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+#ifndef RECORDER_H
+#define RECORDER_H
+
+// clang-format off
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "esp_err.h"
+#include "midi.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+typedef enum
+{
+    REC_STOPPED,
+    REC_RECORDING, // First pass, sets the loop length
+    REC_PLAYING,
+    REC_OVERDUB,
+    REC_STATE_COUNT,
+} rec_state_t;
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+esp_err_t recorder_init(void);
+void recorder_set_state(rec_state_t state);
+rec_state_t recorder_get_state(void);
+void recorder_clear(void);
+uint32_t recorder_get_count(void);
+
+void recorder_append(const midi_message_t *msg, int64_t time_us);
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
+
+#endif /* !RECORDER_H */
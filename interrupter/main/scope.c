@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file scope.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "scope.h"
+#include <math.h>
+#include <stdbool.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define FULL_SCALE 2048
+#define FLOOR_DB (-60.0f)
+#define TWO_PI 6.28318531f
+
+// Peak bin of a full scale sine through the Hann window
+#define FFT_REF (FULL_SCALE * SCOPE_FFT_SIZE / 4.0f)
+
+#define BINS_PER_BAND (SCOPE_FFT_SIZE / 2 / SCOPE_BANDS)
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static float window[SCOPE_FFT_SIZE];
+static float twiddle_re[SCOPE_FFT_SIZE / 2];
+static float twiddle_im[SCOPE_FFT_SIZE / 2];
+static bool tables_ready = false;
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static void scope_tables(void)
+{
+    for (int i = 0; i < SCOPE_FFT_SIZE; i++)
+        window[i] = 0.5f - 0.5f * cosf(TWO_PI * i / SCOPE_FFT_SIZE);
+
+    for (int i = 0; i < SCOPE_FFT_SIZE / 2; i++)
+    {
+        twiddle_re[i] = cosf(TWO_PI * i / SCOPE_FFT_SIZE);
+        twiddle_im[i] = -sinf(TWO_PI * i / SCOPE_FFT_SIZE);
+    }
+
+    tables_ready = true;
+}
+
+// In place radix 2 decimation in time
+static void scope_fft(float *re, float *im)
+{
+    const int n = SCOPE_FFT_SIZE;
+
+    for (int i = 1, j = 0; i < n; i++)
+    {
+        int bit = n >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j)
+        {
+            float t = re[i];
+            re[i] = re[j];
+            re[j] = t;
+            t = im[i];
+            im[i] = im[j];
+            im[j] = t;
+        }
+    }
+
+    for (int len = 2; len <= n; len <<= 1)
+    {
+        int half = len / 2;
+        int step = n / len;
+        for (int i = 0; i < n; i += len)
+        {
+            for (int k = 0; k < half; k++)
+            {
+                float wr = twiddle_re[k * step];
+                float wi = twiddle_im[k * step];
+                int a = i + k;
+                int b = a + half;
+                float tr = re[b] * wr - im[b] * wi;
+                float ti = re[b] * wi + im[b] * wr;
+                re[b] = re[a] - tr;
+                im[b] = im[a] - ti;
+                re[a] += tr;
+                im[a] += ti;
+            }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+void scope_waveform(const int16_t *samples, int16_t *points)
+{
+    // Trigger on the mean, the input sits slightly off 0
+    int32_t sum = 0;
+    for (int i = 0; i < SCOPE_SAMPLES; i++) sum += samples[i];
+    int16_t mean = sum / SCOPE_SAMPLES;
+
+    int start = 0;
+    for (int i = 1; i < SCOPE_TRIGGER_SPAN; i++)
+    {
+        if (samples[i - 1] < mean && samples[i] >= mean)
+        {
+            start = i;
+            break;
+        }
+    }
+
+    const int16_t *s = &samples[start];
+    for (int p = 0; p < SCOPE_POINTS; p++)
+    {
+        int32_t acc = 0;
+        for (int k = 0; k < SCOPE_DECIMATION; k++) acc += *s++;
+        points[p] = acc / SCOPE_DECIMATION;
+    }
+}
+
+void scope_spectrum(const int16_t *samples, int16_t *levels)
+{
+    float re[SCOPE_FFT_SIZE];
+    float im[SCOPE_FFT_SIZE];
+
+    if (!tables_ready) scope_tables();
+
+    // DC removed first, it would leak into the low bands
+    float mean = 0;
+    for (int i = 0; i < SCOPE_FFT_SIZE; i++) mean += samples[i];
+    mean /= SCOPE_FFT_SIZE;
+
+    for (int i = 0; i < SCOPE_FFT_SIZE; i++)
+    {
+        re[i] = (samples[i] - mean) * window[i];
+        im[i] = 0;
+    }
+    scope_fft(re, im);
+
+    for (int band = 0; band < SCOPE_BANDS; band++)
+    {
+        // Strongest bin of the band, bin 0 left out
+        float peak = 0;
+        for (int k = 0; k < BINS_PER_BAND; k++)
+        {
+            int bin = 1 + band * BINS_PER_BAND + k;
+            float power = re[bin] * re[bin] + im[bin] * im[bin];
+            if (power > peak) peak = power;
+        }
+
+        float db = 10 * log10f(peak / (FFT_REF * FFT_REF) + 1e-12f);
+        float level = (db - FLOOR_DB) * SCOPE_LEVEL_MAX / -FLOOR_DB;
+        if (level < 0) level = 0;
+        if (level > SCOPE_LEVEL_MAX) level = SCOPE_LEVEL_MAX;
+        levels[band] = (int16_t)level;
+    }
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file scope.h
+ * @brief Waveform and spectrum of the audio input, for the scope screen
+ *
+ * Works on the latest input samples (signed, full scale 2048), copied out
+ * of the audio input ring by the UI task. The waveform starts on a rising
+ * zero crossing so a steady tone stands still, and is decimated by box
+ * averaging to one point per column. The spectrum is a Hann windowed
+ * 128 point FFT, in bands of 0 (-60 dBFS) to 100 (full scale).
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+#ifndef SCOPE_H
+#define SCOPE_H
+
+// clang-format off
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define SCOPE_POINTS 128      // Waveform points, one per column
+#define SCOPE_DECIMATION 2    // Input samples per point
+#define SCOPE_TRIGGER_SPAN 64 // Samples searched for the trigger
+#define SCOPE_SAMPLES (SCOPE_TRIGGER_SPAN + SCOPE_POINTS * SCOPE_DECIMATION)
+
+#define SCOPE_FFT_SIZE 128
+#define SCOPE_BANDS 32
+#define SCOPE_LEVEL_MAX 100
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+// SCOPE_SAMPLES samples in, SCOPE_POINTS points out
+void scope_waveform(const int16_t *samples, int16_t *points);
+
+// SCOPE_FFT_SIZE samples in, SCOPE_BANDS levels out
+void scope_spectrum(const int16_t *samples, int16_t *levels);
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
+
+#endif /* !SCOPE_H */
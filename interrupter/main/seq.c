@@ -0,0 +1,560 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file seq.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "seq.h"
+#include "clock.h"
+#include "driver/gptimer.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "nvs.h"
+#include "synth.h"
+#include "voice.h"
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define SEQ_TIMER_HZ 1000000
+#define SEQ_CHANNEL 15
+#define SEQ_GATE CONFIG_INTERRUPT_SEQ_GATE // % of the step
+#define SEQ_START_DELAY 1000               // Ticks before the first step
+
+// Two sixteenth notes, in timer ticks
+#define PAIR_TICKS(bpm) (30ULL * SEQ_TIMER_HZ / (bpm))
+
+#define ARP_MAX_NOTES 16
+
+#define CLOCKS_PER_PAIR (CLOCK_PPQN / 2)
+#define CLOCK_TIMEOUT_TICKS (2 * SEQ_TIMER_HZ) // Back to the internal tempo
+
+#define NVS_NAMESPACE "seq"
+#define NVS_KEY "bank"
+#define BANK_VERSION 1
+
+#define TAG "seq"
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+typedef struct
+{
+    uint16_t version;
+    uint16_t bpm;
+    uint8_t swing;
+    uint8_t arp_mode;
+    seq_pattern_t patterns[SEQ_PATTERNS];
+} seq_bank_t;
+
+typedef struct
+{
+    uint8_t note;
+    uint8_t velocity;
+} arp_note_t;
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static seq_bank_t bank;
+static bool dirty = false;
+
+static gptimer_handle_t seq_timer = NULL;
+static volatile bool running = false;
+static portMUX_TYPE seq_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Held notes for the arpeggiator, sorted by pitch
+static arp_note_t arp_notes[ARP_MAX_NOTES];
+static uint8_t arp_count = 0;
+
+// External clock. The task side feeds the PLL, the ISR picks up the pair
+// length and the last pair boundary under seq_lock.
+static clock_pll_t pll;
+static uint32_t clock_count;  // Clocks since start, 0 is a pair boundary
+static int64_t timer_epoch_us; // esp_timer time at timer count 0
+static bool start_pending = false;
+static bool start_resume = false;
+static uint32_t ext_pair = 0; // 0 when running on the internal tempo
+static int64_t ext_pair_at;   // Timer count of the last clock pair boundary
+static int64_t ext_last_at;   // Timer count of the last clock
+static bool ext_sync = false;
+
+// Timer ISR state. Step times derive from the start of the current tempo
+// segment and the step index, not from the previous alarm.
+static uint64_t seg_start;
+static uint32_t seg_pair;
+static uint32_t seg_pairs;
+static uint8_t pair_step; // 0 or 1 within the swing pair
+static uint64_t step_at;
+static uint64_t gate_off_at;
+static uint8_t cur_pattern;
+static uint8_t cur_step;
+static int8_t arp_index;
+static int8_t arp_dir;
+static uint32_t arp_rand = 0x2545F491;
+static bool gate_open = false;
+static uint8_t gate_note;
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static void seq_bank_defaults(void)
+{
+    memset(&bank, 0, sizeof(bank));
+    bank.version = BANK_VERSION;
+    bank.bpm = 120;
+    bank.swing = SEQ_SWING_MIN;
+    bank.arp_mode = SEQ_ARP_OFF;
+
+    for (int p = 0; p < SEQ_PATTERNS; p++)
+    {
+        bank.patterns[p].length = SEQ_STEPS;
+        bank.patterns[p].next = p;
+        for (int s = 0; s < SEQ_STEPS; s++)
+            bank.patterns[p].steps[s].note = 48;
+    }
+
+    // Four on the floor so a fresh unit does something
+    for (int s = 0; s < SEQ_STEPS; s += 4)
+        bank.patterns[0].steps[s].velocity = 100;
+}
+
+static void seq_bank_load(void)
+{
+    nvs_handle_t nvs;
+    size_t size = sizeof(bank);
+
+    seq_bank_defaults();
+    if (nvs_open(NVS_NAMESPACE, NVS_READONLY, &nvs) != ESP_OK) return;
+
+    static seq_bank_t stored;
+    if (nvs_get_blob(nvs, NVS_KEY, &stored, &size) == ESP_OK &&
+        size == sizeof(stored) && stored.version == BANK_VERSION)
+    {
+        bank = stored;
+        ESP_LOGI(TAG, "Patterns loaded");
+    }
+    nvs_close(nvs);
+}
+
+static bool IRAM_ATTR seq_post(bool on, uint8_t note, uint8_t velocity)
+{
+    midi_message_t msg = {
+        .type = MIDI_MSG_NOTE,
+        .channel = SEQ_CHANNEL,
+        .state = on,
+        .note = note,
+        .velocity = velocity,
+    };
+    return synth_post_from_isr(&msg);
+}
+
+// Next arpeggiated note, false when nothing is held
+static bool IRAM_ATTR arp_next(arp_note_t *out)
+{
+    bool found = false;
+
+    portENTER_CRITICAL_ISR(&seq_lock);
+    uint8_t n = arp_count;
+    if (n > 0)
+    {
+        switch (bank.arp_mode)
+        {
+        case SEQ_ARP_UP:
+            arp_index = (arp_index + 1) % n;
+            break;
+        case SEQ_ARP_DOWN:
+            arp_index =
+                arp_index <= 0 || arp_index >= n ? n - 1 : arp_index - 1;
+            break;
+        case SEQ_ARP_UP_DOWN:
+            // Bounce without repeating the end notes
+            if (n == 1)
+                arp_index = 0;
+            else
+            {
+                if (arp_index + arp_dir < 0 || arp_index + arp_dir >= n)
+                    arp_dir = -arp_dir;
+                arp_index += arp_dir;
+                if (arp_index >= n) arp_index = n - 1;
+            }
+            break;
+        default:
+            arp_rand ^= arp_rand << 13;
+            arp_rand ^= arp_rand >> 17;
+            arp_rand ^= arp_rand << 5;
+            arp_index = arp_rand % n;
+            break;
+        }
+        *out = arp_notes[arp_index];
+        found = true;
+    }
+    portEXIT_CRITICAL_ISR(&seq_lock);
+
+    return found;
+}
+
+// Resuming keeps the pattern position and the swing phase
+static void seq_run(bool resume)
+{
+    if (running) return;
+
+    seg_pair = ext_pair ? ext_pair : PAIR_TICKS(bank.bpm);
+    seg_start = SEQ_START_DELAY;
+    seg_pairs = 0;
+    step_at = SEQ_START_DELAY;
+    if (resume && pair_step == 1)
+        seg_start -= (uint64_t)seg_pair * bank.swing / 100;
+    else
+        pair_step = 0;
+    if (!resume || cur_pattern >= SEQ_PATTERNS)
+    {
+        cur_pattern = 0;
+        cur_step = 0;
+    }
+    arp_index = -1;
+    arp_dir = 1;
+    gate_open = false;
+
+    // Clock times are relative to the timer count, drop the old epoch's
+    portENTER_CRITICAL(&seq_lock);
+    ext_sync = false;
+    ext_last_at = 0;
+    portEXIT_CRITICAL(&seq_lock);
+
+    gptimer_set_raw_count(seq_timer, 0);
+    gptimer_alarm_config_t alarm_config = {.alarm_count = step_at};
+    gptimer_set_alarm_action(seq_timer, &alarm_config);
+    timer_epoch_us = esp_timer_get_time();
+    gptimer_start(seq_timer);
+    running = true;
+
+    ESP_LOGI(TAG, "%s at %lu BPM", resume ? "Resumed" : "Started",
+             (unsigned long)(30 * SEQ_TIMER_HZ / seg_pair));
+}
+
+// Called at the start of each pair: picks up tempo changes and slews the
+// phase toward the external clock, at most an eighth of a pair at a time
+static void IRAM_ATTR seq_pair_sync(void)
+{
+    portENTER_CRITICAL_ISR(&seq_lock);
+    if (ext_pair && (int64_t)step_at - ext_last_at > CLOCK_TIMEOUT_TICKS)
+        ext_pair = 0;
+    int64_t pair = ext_pair ? ext_pair : PAIR_TICKS(bank.bpm);
+    bool sync = ext_sync && ext_pair;
+    int64_t sync_at = ext_pair_at;
+    ext_sync = false;
+    portEXIT_CRITICAL_ISR(&seq_lock);
+
+    int64_t shift = 0;
+    if (sync)
+    {
+        shift = ((int64_t)step_at - sync_at) % pair;
+        if (shift > pair / 2) shift -= pair;
+        if (shift < -pair / 2) shift += pair;
+        if (shift > pair / 8) shift = pair / 8;
+        if (shift < -pair / 8) shift = -pair / 8;
+    }
+
+    if (pair != seg_pair || shift != 0)
+    {
+        seg_start = step_at - shift;
+        seg_pair = pair;
+        seg_pairs = 0;
+    }
+}
+
+static void seq_clock_tick(int64_t time_us)
+{
+    clock_pll_tick(&pll, time_us);
+
+    if (start_pending)
+    {
+        // The first clock after start is the downbeat
+        start_pending = false;
+        seq_run(start_resume);
+        if (!start_resume) clock_count = 0;
+    }
+
+    uint32_t tick = clock_count++;
+    if (!pll.locked) return;
+
+    portENTER_CRITICAL(&seq_lock);
+    ext_pair = (uint32_t)(((int64_t)pll.period_q8 * CLOCKS_PER_PAIR) >>
+                          CLOCK_SHIFT);
+    ext_last_at = time_us - timer_epoch_us;
+    if (tick % CLOCKS_PER_PAIR == 0)
+    {
+        ext_pair_at = clock_pll_predict(&pll, 0) - timer_epoch_us;
+        ext_sync = running;
+    }
+    portEXIT_CRITICAL(&seq_lock);
+
+#if CONFIG_INTERRUPT_CLOCK_LFO_BEATS > 0
+    // One LFO cycle every few beats, retuned once per beat
+    if (tick % CLOCK_PPQN == 0)
+        voice_set_lfo_period(((int64_t)pll.period_q8 * CLOCK_PPQN *
+                              CONFIG_INTERRUPT_CLOCK_LFO_BEATS) >>
+                             CLOCK_SHIFT);
+#endif
+}
+
+static bool IRAM_ATTR seq_timer_cb(gptimer_handle_t timer,
+                                   const gptimer_alarm_event_data_t *edata,
+                                   void *user_ctx)
+{
+    uint64_t now = edata->alarm_value;
+    bool yield = false;
+
+    if (gate_open && now >= gate_off_at)
+    {
+        yield |= seq_post(false, gate_note, 0);
+        gate_open = false;
+    }
+
+    if (now >= step_at)
+    {
+        if (gate_open)
+        {
+            yield |= seq_post(false, gate_note, 0);
+            gate_open = false;
+        }
+
+        // Tempo and clock phase changes take effect on the next swing pair
+        if (pair_step == 0) seq_pair_sync();
+
+        const seq_pattern_t *pat = &bank.patterns[cur_pattern];
+        arp_note_t note = {0};
+        bool play;
+        if (bank.arp_mode != SEQ_ARP_OFF)
+            play = arp_next(&note);
+        else
+        {
+            note.note = pat->steps[cur_step].note;
+            note.velocity = pat->steps[cur_step].velocity;
+            play = note.velocity > 0;
+        }
+
+        // Swing delays the second step of each pair
+        uint64_t pair = seg_pair;
+        uint64_t next_at;
+        if (pair_step == 0)
+        {
+            next_at = seg_start + seg_pairs * pair + pair * bank.swing / 100;
+        }
+        else
+        {
+            seg_pairs++;
+            next_at = seg_start + seg_pairs * pair;
+        }
+
+        if (play)
+        {
+            yield |= seq_post(true, note.note, note.velocity);
+            gate_open = true;
+            gate_note = note.note;
+            gate_off_at = step_at + (next_at - step_at) * SEQ_GATE / 100;
+        }
+
+        step_at = next_at;
+        pair_step ^= 1;
+
+        if (++cur_step >= pat->length)
+        {
+            cur_step = 0;
+            cur_pattern = pat->next < SEQ_PATTERNS ? pat->next : 0;
+        }
+    }
+
+    uint64_t alarm = step_at;
+    if (gate_open && gate_off_at < alarm) alarm = gate_off_at;
+
+    gptimer_alarm_config_t alarm_config = {.alarm_count = alarm};
+    gptimer_set_alarm_action(timer, &alarm_config);
+
+    return yield;
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+void seq_init(void)
+{
+    seq_bank_load();
+    clock_pll_reset(&pll);
+
+    gptimer_config_t timer_config = {
+        .clk_src = GPTIMER_CLK_SRC_DEFAULT,
+        .direction = GPTIMER_COUNT_UP,
+        .resolution_hz = SEQ_TIMER_HZ,
+    };
+    ESP_ERROR_CHECK(gptimer_new_timer(&timer_config, &seq_timer));
+    gptimer_event_callbacks_t timer_cbs = {.on_alarm = seq_timer_cb};
+    ESP_ERROR_CHECK(
+        gptimer_register_event_callbacks(seq_timer, &timer_cbs, NULL));
+    ESP_ERROR_CHECK(gptimer_enable(seq_timer));
+}
+
+void seq_start(void) { seq_run(false); }
+
+void seq_stop(void)
+{
+    if (!running) return;
+
+    gptimer_stop(seq_timer);
+    running = false;
+
+    if (gate_open)
+    {
+        midi_message_t msg = {
+            .type = MIDI_MSG_NOTE, .channel = SEQ_CHANNEL, .note = gate_note};
+        synth_post(&msg);
+        gate_open = false;
+    }
+}
+
+bool seq_is_running(void) { return running; }
+
+void seq_set_tempo(uint16_t bpm)
+{
+    if (bpm < SEQ_BPM_MIN) bpm = SEQ_BPM_MIN;
+    if (bpm > SEQ_BPM_MAX) bpm = SEQ_BPM_MAX;
+    dirty |= bank.bpm != bpm;
+    bank.bpm = bpm;
+}
+
+uint16_t seq_get_tempo(void) { return bank.bpm; }
+
+void seq_set_swing(uint8_t swing)
+{
+    if (swing < SEQ_SWING_MIN) swing = SEQ_SWING_MIN;
+    if (swing > SEQ_SWING_MAX) swing = SEQ_SWING_MAX;
+    dirty |= bank.swing != swing;
+    bank.swing = swing;
+}
+
+uint8_t seq_get_swing(void) { return bank.swing; }
+
+void seq_set_arp_mode(seq_arp_mode_t mode)
+{
+    if (mode >= SEQ_ARP_COUNT) mode = SEQ_ARP_OFF;
+    dirty |= bank.arp_mode != mode;
+    bank.arp_mode = mode;
+}
+
+seq_arp_mode_t seq_get_arp_mode(void) { return bank.arp_mode; }
+
+const seq_pattern_t *seq_get_pattern(uint8_t pattern)
+{
+    return &bank.patterns[pattern < SEQ_PATTERNS ? pattern : 0];
+}
+
+void seq_set_step(uint8_t pattern, uint8_t step, seq_step_t value)
+{
+    if (pattern >= SEQ_PATTERNS || step >= SEQ_STEPS) return;
+    value.note &= 0x7F;
+    value.velocity &= 0x7F;
+    bank.patterns[pattern].steps[step] = value;
+    dirty = true;
+}
+
+void seq_set_length(uint8_t pattern, uint8_t length)
+{
+    if (pattern >= SEQ_PATTERNS || length < 1 || length > SEQ_STEPS) return;
+    bank.patterns[pattern].length = length;
+    dirty = true;
+}
+
+void seq_set_next(uint8_t pattern, uint8_t next)
+{
+    if (pattern >= SEQ_PATTERNS || next >= SEQ_PATTERNS) return;
+    bank.patterns[pattern].next = next;
+    dirty = true;
+}
+
+void seq_clock(const midi_message_t *msg, int64_t time_us)
+{
+    switch (msg->type)
+    {
+    case MIDI_MSG_CLOCK:
+        seq_clock_tick(time_us);
+        break;
+    case MIDI_MSG_START:
+    case MIDI_MSG_CONTINUE:
+        start_pending = true;
+        start_resume = msg->type == MIDI_MSG_CONTINUE;
+        // Continue picks the clock count up at the same swing phase
+        if (start_resume) clock_count = pair_step * CLOCKS_PER_PAIR / 2;
+        break;
+    case MIDI_MSG_STOP:
+        start_pending = false;
+        seq_stop();
+        break;
+    default:
+        break;
+    }
+}
+
+void seq_arp_note(const midi_message_t *msg)
+{
+    portENTER_CRITICAL(&seq_lock);
+
+    int i = 0;
+    while (i < arp_count && arp_notes[i].note < msg->note) i++;
+    bool held = i < arp_count && arp_notes[i].note == msg->note;
+
+    if (msg->state && !held && arp_count < ARP_MAX_NOTES)
+    {
+        memmove(&arp_notes[i + 1], &arp_notes[i],
+                (arp_count - i) * sizeof(arp_note_t));
+        arp_notes[i] = (arp_note_t){msg->note, msg->velocity};
+        arp_count++;
+    }
+    else if (!msg->state && held)
+    {
+        memmove(&arp_notes[i], &arp_notes[i + 1],
+                (arp_count - i - 1) * sizeof(arp_note_t));
+        arp_count--;
+    }
+
+    portEXIT_CRITICAL(&seq_lock);
+}
+
+esp_err_t seq_save(void)
+{
+    if (!dirty) return ESP_OK;
+
+    nvs_handle_t nvs;
+    esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs);
+    if (err == ESP_OK)
+    {
+        err = nvs_set_blob(nvs, NVS_KEY, &bank, sizeof(bank));
+        if (err == ESP_OK) err = nvs_commit(nvs);
+        nvs_close(nvs);
+    }
+
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to save patterns: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    dirty = false;
+    ESP_LOGI(TAG, "Patterns saved");
+    return ESP_OK;
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file seq.h
+ * @brief Step sequencer and arpeggiator
+ *
+ * Steps are sixteenth notes clocked by a dedicated hardware timer: every
+ * alarm is programmed at an absolute count computed from the step index,
+ * so timing never accumulates error whatever the task load. The ISR posts
+ * the notes to the synth queue, they sound on the next control tick.
+ *
+ * When the arpeggiator is enabled, the notes held on the MIDI inputs are
+ * played one per step instead of the pattern. Patterns are chained through
+ * their next field and persisted in NVS with seq_save().
+ *
+ * seq_clock() follows an external MIDI clock: once the tempo PLL is locked
+ * the step length comes from the clock and the phase is slewed at every
+ * swing pair toward the clock's sixteenth notes. Start and continue take
+ * effect on the next clock, the downbeat. Without clock for two seconds
+ * the internal tempo is used again.
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+#ifndef SEQ_H
+#define SEQ_H
+
+// clang-format off
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "esp_err.h"
+#include "midi.h"
+#include "sdkconfig.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define SEQ_STEPS 16
+#define SEQ_PATTERNS CONFIG_INTERRUPT_SEQ_PATTERNS
+
+#define SEQ_BPM_MIN 20
+#define SEQ_BPM_MAX 300
+#define SEQ_SWING_MIN 50 // Straight
+#define SEQ_SWING_MAX 75
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+typedef enum
+{
+    SEQ_ARP_OFF,
+    SEQ_ARP_UP,
+    SEQ_ARP_DOWN,
+    SEQ_ARP_UP_DOWN,
+    SEQ_ARP_RANDOM,
+    SEQ_ARP_COUNT,
+} seq_arp_mode_t;
+
+typedef struct
+{
+    uint8_t note;
+    uint8_t velocity; // 0 is a rest
+} seq_step_t;
+
+typedef struct
+{
+    seq_step_t steps[SEQ_STEPS];
+    uint8_t length;
+    uint8_t next; // Pattern played after this one
+} seq_pattern_t;
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+void seq_init(void);
+void seq_start(void);
+void seq_stop(void);
+bool seq_is_running(void);
+
+void seq_set_tempo(uint16_t bpm);
+uint16_t seq_get_tempo(void);
+void seq_set_swing(uint8_t swing);
+uint8_t seq_get_swing(void);
+void seq_set_arp_mode(seq_arp_mode_t mode);
+seq_arp_mode_t seq_get_arp_mode(void);
+
+const seq_pattern_t *seq_get_pattern(uint8_t pattern);
+void seq_set_step(uint8_t pattern, uint8_t step, seq_step_t value);
+void seq_set_length(uint8_t pattern, uint8_t length);
+void seq_set_next(uint8_t pattern, uint8_t next);
+
+void seq_arp_note(const midi_message_t *msg);
+void seq_clock(const midi_message_t *msg, int64_t time_us);
+
+esp_err_t seq_save(void);
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
+
+#endif /* !SEQ_H */
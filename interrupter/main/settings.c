@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file settings.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "settings.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "nvs.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define TAG "settings"
+
+#define NVS_NAMESPACE "settings"
+#define SETTLE_US (CONFIG_INTERRUPT_SETTINGS_SETTLE_MS * 1000LL)
+
+_Static_assert(SETTINGS_PRESETS <= 9, "One digit preset keys");
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static settings_record_t staged[SETTINGS_RECORDS];
+static size_t staged_count = 0;
+static bool dirty = false;
+static int64_t changed_us = 0;
+
+static settings_stats_t stats = {0};
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static void settings_key(uint8_t slot, char *key, size_t size)
+{
+    if (slot == SETTINGS_CURRENT)
+        snprintf(key, size, "current");
+    else
+        snprintf(key, size, "preset%u", slot);
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+size_t settings_read(uint8_t slot, settings_record_t *records, size_t max)
+{
+    int64_t start = esp_timer_get_time();
+    char key[NVS_KEY_NAME_MAX_SIZE];
+    settings_key(slot, key, sizeof(key));
+
+    nvs_handle_t nvs;
+    if (nvs_open(NVS_NAMESPACE, NVS_READONLY, &nvs) != ESP_OK) return 0;
+
+    size_t size = max * sizeof(*records);
+    esp_err_t err = nvs_get_blob(nvs, key, records, &size);
+    nvs_close(nvs);
+    if (err != ESP_OK || size % sizeof(*records)) return 0;
+    size_t count = size / sizeof(*records);
+
+    if (slot == SETTINGS_CURRENT)
+    {
+        // What flash holds, staging it again is no change
+        staged_count = count < SETTINGS_RECORDS ? count : SETTINGS_RECORDS;
+        memcpy(staged, records, staged_count * sizeof(*records));
+        stats.read_us = esp_timer_get_time() - start;
+    }
+    return count;
+}
+
+esp_err_t settings_write(uint8_t slot, const settings_record_t *records,
+                         size_t count)
+{
+    int64_t start = esp_timer_get_time();
+    char key[NVS_KEY_NAME_MAX_SIZE];
+    settings_key(slot, key, sizeof(key));
+
+    nvs_handle_t nvs;
+    esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs);
+    if (err == ESP_OK)
+    {
+        err = nvs_set_blob(nvs, key, records, count * sizeof(*records));
+        if (err == ESP_OK) err = nvs_commit(nvs);
+        nvs_close(nvs);
+    }
+
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to save %s: %s", key, esp_err_to_name(err));
+        return err;
+    }
+
+    stats.writes++;
+    stats.write_us = esp_timer_get_time() - start;
+    ESP_LOGI(TAG, "Saved %s in %lu us, %lu writes for %lu changes", key,
+             stats.write_us, stats.writes, stats.staged);
+    return ESP_OK;
+}
+
+void settings_stage(const settings_record_t *records, size_t count)
+{
+    if (count > SETTINGS_RECORDS) count = SETTINGS_RECORDS;
+
+    // Unchanged settings cost nothing, not even a restart of the wait
+    if (count == staged_count &&
+        memcmp(staged, records, count * sizeof(*records)) == 0)
+        return;
+
+    memcpy(staged, records, count * sizeof(*records));
+    staged_count = count;
+    dirty = true;
+    changed_us = esp_timer_get_time();
+    stats.staged++;
+}
+
+void settings_poll(void)
+{
+    if (!dirty || esp_timer_get_time() - changed_us < SETTLE_US) return;
+
+    // Tried again after another wait if the write fails
+    if (settings_write(SETTINGS_CURRENT, staged, staged_count) == ESP_OK)
+        dirty = false;
+    else
+        changed_us = esp_timer_get_time();
+}
+
+void settings_get_stats(settings_stats_t *out) { *out = stats; }
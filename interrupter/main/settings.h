@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file settings.h
+ * @brief Parameter values kept in NVS: the current settings and user presets
+ *
+ * A slot is one blob of name and value records, so parameters added or
+ * reordered later still find their stored values. Slot 0 holds the current
+ * settings. They are staged on every change but only written once they
+ * have stopped changing for CONFIG_INTERRUPT_SETTINGS_SETTLE_MS, from the
+ * task that polls, so a knob spin costs one flash write. The presets, slots
+ * 1 and up, are written at once on request.
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+#ifndef SETTINGS_H
+#define SETTINGS_H
+
+// clang-format off
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "esp_err.h"
+#include "sdkconfig.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define SETTINGS_PRESETS CONFIG_INTERRUPT_PRESETS
+#define SETTINGS_CURRENT 0 // Slot of the current settings
+#define SETTINGS_RECORDS 32
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+typedef struct
+{
+    char name[4];
+    int16_t value;
+} settings_record_t;
+
+typedef struct
+{
+    uint32_t staged;   // Changes handed over
+    uint32_t writes;   // Blobs written to flash
+    uint32_t read_us;  // Restore of the current settings at boot
+    uint32_t write_us; // Last write, erase included
+} settings_stats_t;
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+// Records stored in slot, 0 when empty
+size_t settings_read(uint8_t slot, settings_record_t *records, size_t max);
+
+esp_err_t settings_write(uint8_t slot, const settings_record_t *records,
+                         size_t count);
+
+// Current settings, written by settings_poll() once they settle
+void settings_stage(const settings_record_t *records, size_t count);
+void settings_poll(void);
+
+void settings_get_stats(settings_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
+
+#endif /* !SETTINGS_H */
@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file show.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "show.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "pwm.h"
+#include "sdkconfig.h"
+#include "timeline.h"
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define PARTITION_LABEL CONFIG_INTERRUPT_SHOW_PARTITION
+
+// Do not hand out pulses further than this, the ISR keeps polling instead
+#define LOOKAHEAD_Q8 (1UL << 30)
+
+#define TAG "show"
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static const uint8_t *part_data = NULL;
+static size_t part_size = 0;
+static esp_partition_mmap_handle_t part_mmap;
+
+static tl_reader_t reader;
+static tl_pulse_t next;
+static bool has_next = false;
+static volatile bool restart = false;
+static uint32_t from_us = 0;
+static volatile bool playing = false;
+static volatile bool ended = false; // Pulse source still to be put back
+
+// Pulse timer time unwrapped to 64 bits, timeline events can be further
+// apart than the 32 bit Q8 ticks of the scheduler reach
+static uint64_t clock_q8 = 0;
+static uint32_t last_q8 = 0;
+static uint64_t t0_q8 = 0;
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+// Pulse source, runs in the pulse timer ISR
+static bool show_next_pulse(uint32_t now_q8, voice_pulse_t *pulse)
+{
+    // Called at least every PULSE_IDLE_POLL, far below the wrap
+    clock_q8 += (uint32_t)(now_q8 - last_q8);
+    last_q8 = now_q8;
+
+    if (restart)
+    {
+        restart = false;
+        t0_q8 = clock_q8 - ((uint64_t)from_us << VOICE_PERIOD_SHIFT);
+        has_next = tl_seek(&reader, from_us) && tl_next(&reader, &next);
+    }
+
+    if (!has_next)
+    {
+#if CONFIG_INTERRUPT_SHOW_LOOP
+        from_us = 0;
+        restart = true;
+#else
+        // The voices get the output back from show_poll()
+        playing = false;
+        ended = true;
+#endif
+        return false;
+    }
+
+    // Held until it is within the lookahead, late ones fire at once
+    int64_t in_q8 = (int64_t)(t0_q8 +
+                              ((uint64_t)next.time_us << VOICE_PERIOD_SHIFT) -
+                              clock_q8);
+    if (in_q8 > (int64_t)LOOKAHEAD_Q8) return false;
+    if (in_q8 < 0) in_q8 = 0;
+
+    // A single output pin, every timeline output is played on it
+    pulse->at_q8 = now_q8 + (uint32_t)in_q8;
+    pulse->width_tick = next.width_tick;
+    has_next = tl_next(&reader, &next);
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+esp_err_t show_init(void)
+{
+    const esp_partition_t *part = esp_partition_find_first(
+        ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, PARTITION_LABEL);
+    if (part == NULL)
+    {
+        ESP_LOGW(TAG, "No '%s' partition", PARTITION_LABEL);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    const void *ptr;
+    esp_err_t err = esp_partition_mmap(part, 0, part->size,
+                                       ESP_PARTITION_MMAP_DATA, &ptr,
+                                       &part_mmap);
+    if (err != ESP_OK) return err;
+
+    // Stays mapped while a timeline is there to play, an erased partition
+    // gives the address space back
+    if (!tl_open(&reader, ptr, part->size))
+    {
+        esp_partition_munmap(part_mmap);
+        ESP_LOGW(TAG, "No valid timeline in '%s'", PARTITION_LABEL);
+        return ESP_ERR_INVALID_VERSION;
+    }
+    part_data = ptr;
+    part_size = part->size;
+
+    ESP_LOGI(TAG, "Timeline: %lu pulses, %lu ms", reader.hdr->record_count,
+             reader.hdr->duration_us / 1000);
+
+    return ESP_OK;
+}
+
+esp_err_t show_play(uint32_t start_us)
+{
+    if (part_data == NULL) return ESP_ERR_INVALID_STATE;
+    if (pwm_get_mode() != PWM_MIDI) return ESP_ERR_INVALID_STATE;
+
+    // Picked up by the ISR on its next run
+    from_us = start_us;
+    restart = true;
+    playing = true;
+    ended = false;
+    pwm_set_pulse_source(show_next_pulse);
+
+    return ESP_OK;
+}
+
+void show_stop(void)
+{
+    if (!playing && !restart) return;
+
+    pwm_set_pulse_source(NULL);
+    playing = false;
+}
+
+void show_poll(void)
+{
+    if (!ended) return;
+
+    ended = false;
+    // Unless a new show started meanwhile
+    if (!playing) pwm_set_pulse_source(NULL);
+}
+
+bool show_is_playing(void) { return playing; }
@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file show.h
+ * @brief Zero-copy playback of a precompiled pulse timeline
+ *
+ * The timeline image (see timeline.h, rendered by tools/pulsetl) is
+ * memory-mapped from a flash partition and decoded directly by the pulse
+ * timer ISR, one record per pulse. No parsing or scheduling runs in tasks
+ * while playing.
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+#ifndef SHOW_H
+#define SHOW_H
+
+// clang-format off
+#ifdef __cplusplus
+extern "C" 
+{
+#endif
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+esp_err_t show_init(void);
+esp_err_t show_play(uint32_t from_us);
+void show_stop(void);
+bool show_is_playing(void);
+
+// Control context, hands the output back to the voices once a show ended
+void show_poll(void);
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
+
+#endif /* !SHOW_H */
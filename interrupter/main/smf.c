@@ -0,0 +1,297 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file smf.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "smf.h"
+#include "midi_parse.h"
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define CHUNK_HEADER_SIZE 8
+#define MTHD_SIZE 6
+
+#define DEFAULT_TEMPO_US 500000 // 120 BPM
+
+#define META_EVENT 0xFF
+#define META_END_OF_TRACK 0x2F
+#define META_TEMPO 0x51
+#define SYSEX_EVENT 0xF0
+#define SYSEX_ESCAPE 0xF7
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static inline uint32_t read_be32(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+           ((uint32_t)p[2] << 8) | p[3];
+}
+
+static inline uint16_t read_be16(const uint8_t *p)
+{
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+static bool read_vlq(smf_track_t *trk, uint32_t *value)
+{
+    uint32_t v = 0;
+
+    // At most 4 bytes (28 bits)
+    for (int i = 0; i < 4; i++)
+    {
+        if (trk->pos >= trk->end) return false;
+        uint8_t b = *trk->pos++;
+        v = (v << 7) | (b & 0x7F);
+        if (!(b & 0x80))
+        {
+            *value = v;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static inline void track_end(smf_track_t *trk) { trk->pos = trk->end; }
+
+static inline bool track_ended(const smf_track_t *trk)
+{
+    return trk->pos >= trk->end;
+}
+
+static void track_read_delta(smf_track_t *trk)
+{
+    uint32_t delta;
+    if (read_vlq(trk, &delta))
+        trk->next_tick += delta;
+    else
+        track_end(trk);
+}
+
+// Min-heap on next_tick, the track index breaks ties so that simultaneous
+// events come out in track order (tempo map first in format 1)
+static inline bool heap_less(const smf_t *smf, uint8_t a, uint8_t b)
+{
+    uint32_t ta = smf->tracks[a].next_tick;
+    uint32_t tb = smf->tracks[b].next_tick;
+    return ta < tb || (ta == tb && a < b);
+}
+
+static void heap_sift_down(smf_t *smf, uint8_t i)
+{
+    while (1)
+    {
+        uint8_t l = 2 * i + 1;
+        uint8_t r = l + 1;
+        uint8_t min = i;
+
+        if (l < smf->heap_len && heap_less(smf, smf->heap[l], smf->heap[min]))
+            min = l;
+        if (r < smf->heap_len && heap_less(smf, smf->heap[r], smf->heap[min]))
+            min = r;
+        if (min == i) return;
+
+        uint8_t tmp = smf->heap[i];
+        smf->heap[i] = smf->heap[min];
+        smf->heap[min] = tmp;
+        i = min;
+    }
+}
+
+static uint64_t smf_tick_to_us(const smf_t *smf, uint32_t tick)
+{
+    uint64_t ticks = tick - smf->seg_tick;
+
+    if (smf->division & 0x8000)
+    {
+        // SMPTE: -frames per second in the high byte, ticks per frame low
+        uint32_t fps = (uint8_t)(-(int8_t)(smf->division >> 8));
+        uint32_t tpf = smf->division & 0xFF;
+        return smf->seg_us + ticks * 1000000ULL / (fps * tpf);
+    }
+
+    return smf->seg_us + ticks * smf->tempo_us / smf->division;
+}
+
+static void smf_set_tempo(smf_t *smf, uint32_t tick, uint32_t tempo_us)
+{
+    // Restart the conversion segment, no rounding drift accumulates
+    smf->seg_us = smf_tick_to_us(smf, tick);
+    smf->seg_tick = tick;
+    smf->tempo_us = tempo_us;
+}
+
+// Parse the event at the track cursor. Returns true when it is a channel
+// message we forward.
+static bool track_parse_event(smf_t *smf, smf_track_t *trk,
+                              midi_message_t *msg)
+{
+    if (track_ended(trk)) return false;
+
+    uint8_t status = *trk->pos;
+    if (status & 0x80)
+    {
+        trk->pos++;
+    }
+    else
+    {
+        // Running status
+        status = trk->running_status;
+        if (!(status & 0x80))
+        {
+            track_end(trk);
+            return false;
+        }
+    }
+
+    if (status == META_EVENT)
+    {
+        trk->running_status = 0;
+        if (trk->pos >= trk->end)
+        {
+            track_end(trk);
+            return false;
+        }
+        uint8_t type = *trk->pos++;
+        uint32_t len;
+        if (!read_vlq(trk, &len) || len > (uint32_t)(trk->end - trk->pos))
+        {
+            track_end(trk);
+            return false;
+        }
+
+        if (type == META_TEMPO && len == 3)
+        {
+            uint32_t tempo = ((uint32_t)trk->pos[0] << 16) |
+                             ((uint32_t)trk->pos[1] << 8) | trk->pos[2];
+            if (tempo > 0) smf_set_tempo(smf, trk->next_tick, tempo);
+        }
+        else if (type == META_END_OF_TRACK)
+        {
+            track_end(trk);
+            return false;
+        }
+
+        trk->pos += len;
+        return false;
+    }
+
+    if (status == SYSEX_EVENT || status == SYSEX_ESCAPE)
+    {
+        trk->running_status = 0;
+        uint32_t len;
+        if (!read_vlq(trk, &len) || len > (uint32_t)(trk->end - trk->pos))
+            track_end(trk);
+        else
+            trk->pos += len;
+        return false;
+    }
+
+    trk->running_status = status;
+
+    uint8_t len = midi_data_length(status);
+    if ((uint32_t)(trk->end - trk->pos) < len)
+    {
+        track_end(trk);
+        return false;
+    }
+
+    uint8_t data1 = trk->pos[0];
+    uint8_t data2 = len > 1 ? trk->pos[1] : 0;
+    trk->pos += len;
+
+    return midi_decode(status, data1, data2, msg);
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+size_t smf_open(smf_t *smf, const uint8_t *data, size_t size)
+{
+    memset(smf, 0, sizeof(*smf));
+    smf->data = data;
+    smf->size = size;
+
+    if (size < CHUNK_HEADER_SIZE + MTHD_SIZE || memcmp(data, "MThd", 4) != 0)
+        return 0;
+
+    uint32_t hdr_len = read_be32(data + 4);
+    if (hdr_len < MTHD_SIZE || hdr_len > size - CHUNK_HEADER_SIZE) return 0;
+
+    smf->format = read_be16(data + 8);
+    smf->track_count = read_be16(data + 10);
+    smf->division = read_be16(data + 12);
+    smf->tempo_us = DEFAULT_TEMPO_US;
+
+    if (smf->format > 1 || smf->division == 0) return 0;
+    if ((smf->division & 0x8000) && (smf->division & 0xFF) == 0) return 0;
+
+    const uint8_t *p = data + CHUNK_HEADER_SIZE + hdr_len;
+    const uint8_t *end = data + size;
+    uint16_t found = 0;
+
+    while (found < smf->track_count && end - p >= CHUNK_HEADER_SIZE)
+    {
+        uint32_t len = read_be32(p + 4);
+        bool is_track = memcmp(p, "MTrk", 4) == 0;
+        p += CHUNK_HEADER_SIZE;
+        if (len > (size_t)(end - p)) len = end - p;
+
+        // Unknown chunks are skipped, extra tracks ignored
+        if (is_track && found < SMF_MAX_TRACKS)
+        {
+            smf_track_t *trk = &smf->tracks[found];
+            trk->pos = p;
+            trk->end = p + len;
+            track_read_delta(trk);
+            if (!track_ended(trk)) smf->heap[smf->heap_len++] = found;
+        }
+        if (is_track) found++;
+        p += len;
+    }
+
+    if (found == 0) return 0;
+
+    for (int i = smf->heap_len / 2 - 1; i >= 0; i--) heap_sift_down(smf, i);
+
+    return (size_t)(p - data);
+}
+
+void smf_rewind(smf_t *smf) { smf_open(smf, smf->data, smf->size); }
+
+bool smf_next(smf_t *smf, smf_event_t *event)
+{
+    while (smf->heap_len > 0)
+    {
+        uint8_t t = smf->heap[0];
+        smf_track_t *trk = &smf->tracks[t];
+        uint32_t tick = trk->next_tick;
+
+        bool forward = track_parse_event(smf, trk, &event->msg);
+        if (forward) event->time_us = smf_tick_to_us(smf, tick);
+
+        if (!track_ended(trk)) track_read_delta(trk);
+        if (track_ended(trk)) smf->heap[0] = smf->heap[--smf->heap_len];
+        heap_sift_down(smf, 0);
+
+        if (forward) return true;
+    }
+
+    return false;
+}
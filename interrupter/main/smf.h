@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file smf.h
+ * @brief Incremental Standard MIDI File parser
+ *
+ * Parses format 0/1 files in place (e.g. from memory-mapped flash). Each
+ * track keeps a cursor, and the tracks are merged in time order through a
+ * small min-heap keyed on the absolute tick of their next event. RAM usage
+ * is sizeof(smf_t) whatever the file size, and opening a file only walks
+ * the chunk headers.
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+#ifndef SMF_H
+#define SMF_H
+
+// clang-format off
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "midi.h"
+#include "sdkconfig.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define SMF_MAX_TRACKS CONFIG_INTERRUPT_SMF_MAX_TRACKS
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+typedef struct
+{
+    const uint8_t *pos;
+    const uint8_t *end;
+    uint32_t next_tick; // Absolute tick of the event at pos
+    uint8_t running_status;
+} smf_track_t;
+
+typedef struct
+{
+    const uint8_t *data;
+    size_t size;
+
+    uint16_t format;
+    uint16_t track_count;
+    uint16_t division; // Ticks per quarter note, or SMPTE when bit 15 set
+
+    smf_track_t tracks[SMF_MAX_TRACKS];
+    uint8_t heap[SMF_MAX_TRACKS];
+    uint8_t heap_len;
+
+    // Tick to time conversion, restarted at every tempo change
+    uint32_t tempo_us;  // Per quarter note
+    uint32_t seg_tick;
+    uint64_t seg_us;
+} smf_t;
+
+typedef struct
+{
+    uint64_t time_us; // Since the start of the file
+    midi_message_t msg;
+} smf_event_t;
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+size_t smf_open(smf_t *smf, const uint8_t *data, size_t size);
+void smf_rewind(smf_t *smf);
+bool smf_next(smf_t *smf, smf_event_t *event);
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
+
+#endif /* !SMF_H */
@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file synth.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "synth.h"
+#include "driver/gptimer.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "sdkconfig.h"
+#include "show.h"
+#include "tasks.h"
+#include "voice.h"
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define CONTROL_RATE_HZ CONFIG_INTERRUPT_CONTROL_RATE_HZ
+#define CONTROL_TIMER_HZ 1000000
+#define SYNTH_QUEUE_LEN 32
+
+#define TAG "synth"
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static QueueHandle_t synth_queue = NULL;
+static gptimer_handle_t control_timer = NULL;
+static TaskHandle_t control_task_handle = NULL;
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static bool IRAM_ATTR control_timer_cb(gptimer_handle_t timer,
+                                       const gptimer_alarm_event_data_t *edata,
+                                       void *user_ctx)
+{
+    BaseType_t woken = pdFALSE;
+    task_wake_stamp(TASK_CONTROL);
+    vTaskNotifyGiveFromISR(control_task_handle, &woken);
+    return woken == pdTRUE;
+}
+
+static void control_task(void *arg)
+{
+    while (1)
+    {
+        // Ticks missed while busy are dropped, not caught up
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        task_woken(TASK_CONTROL);
+
+        midi_message_t msg;
+        while (xQueueReceive(synth_queue, &msg, 0) == pdPASS)
+            voice_handle_message(&msg);
+
+        show_poll();
+        voice_tick();
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+void synth_init(void)
+{
+    voice_init(CONTROL_RATE_HZ);
+
+    synth_queue = xQueueCreate(SYNTH_QUEUE_LEN, sizeof(midi_message_t));
+    control_task_handle = task_start(TASK_CONTROL, control_task, NULL);
+
+    // Its interrupt is served by the core this runs on, the output core
+    gptimer_config_t timer_config = {
+        .clk_src = GPTIMER_CLK_SRC_DEFAULT,
+        .direction = GPTIMER_COUNT_UP,
+        .resolution_hz = CONTROL_TIMER_HZ,
+    };
+    ESP_ERROR_CHECK(gptimer_new_timer(&timer_config, &control_timer));
+    gptimer_event_callbacks_t timer_cbs = {.on_alarm = control_timer_cb};
+    ESP_ERROR_CHECK(
+        gptimer_register_event_callbacks(control_timer, &timer_cbs, NULL));
+    gptimer_alarm_config_t alarm_config = {
+        .alarm_count = CONTROL_TIMER_HZ / CONTROL_RATE_HZ,
+        .reload_count = 0,
+        .flags.auto_reload_on_alarm = true,
+    };
+    ESP_ERROR_CHECK(gptimer_set_alarm_action(control_timer, &alarm_config));
+    ESP_ERROR_CHECK(gptimer_enable(control_timer));
+}
+
+void synth_start(void)
+{
+    xQueueReset(synth_queue);
+    voice_all_off();
+    gptimer_set_raw_count(control_timer, 0);
+    ESP_ERROR_CHECK(gptimer_start(control_timer));
+}
+
+void synth_stop(void)
+{
+    gptimer_stop(control_timer);
+    voice_all_off();
+}
+
+void synth_post(const midi_message_t *msg)
+{
+    if (xQueueSend(synth_queue, msg, 0) != pdPASS)
+    {
+        ESP_LOGW(TAG, "Queue full, message dropped");
+    }
+}
+
+bool IRAM_ATTR synth_post_from_isr(const midi_message_t *msg)
+{
+    BaseType_t woken = pdFALSE;
+    xQueueSendFromISR(synth_queue, msg, &woken);
+    return woken == pdTRUE;
+}
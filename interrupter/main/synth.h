@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file synth.h
+ * @brief MIDI mode control loop
+ *
+ * Incoming MIDI messages are queued and applied to the voice table by the
+ * control task, woken at the control rate by a timer on the output core,
+ * which also runs the modulation engine. All voice state is therefore
+ * touched from a single context, whose lateness the task monitor reports.
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+#ifndef SYNTH_H
+#define SYNTH_H
+
+// clang-format off
+#ifdef __cplusplus
+extern "C" 
+{
+#endif
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "midi.h"
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+void synth_init(void);
+void synth_start(void);
+void synth_stop(void);
+void synth_post(const midi_message_t *msg);
+bool synth_post_from_isr(const midi_message_t *msg);
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
+
+#endif /* !SYNTH_H */
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file tables.h
+ * @brief Note and velocity lookup tables
+ *
+ * The tables are generated at build time from sdkconfig by
+ * tools/gen_tables.py (see main/CMakeLists.txt), at the pulse timer / RMT
+ * tick resolution.
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+#ifndef TABLES_H
+#define TABLES_H
+
+// clang-format off
+#ifdef __cplusplus
+extern "C" 
+{
+#endif
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "sdkconfig.h"
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define TABLE_NOTE_COUNT 128
+#define PITCH_FRAC_STEPS 16 // Fine pitch entries per semitone
+#define PITCH_FRAC_BITS 12  // Q16 semitone fraction >> 12 = fine table index
+
+#if CONFIG_INTERRUPT_VELOCITY_CURVE_LOG
+#define VEL_CURVE_DEFAULT VEL_CURVE_LOG
+#elif CONFIG_INTERRUPT_VELOCITY_CURVE_CUSTOM
+#define VEL_CURVE_DEFAULT VEL_CURVE_CUSTOM
+#else
+#define VEL_CURVE_DEFAULT VEL_CURVE_LINEAR
+#endif
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+typedef enum
+{
+    VEL_CURVE_LINEAR,
+    VEL_CURVE_LOG,
+    VEL_CURVE_CUSTOM,
+    VEL_CURVE_COUNT
+} vel_curve_t;
+
+// -----------------------------------------------------------------------------
+// Variable Declarations
+// -----------------------------------------------------------------------------
+// Period of each MIDI note, Q8 ticks
+extern const uint32_t note_period_q8[TABLE_NOTE_COUNT];
+// 2^(-i / (12 * PITCH_FRAC_STEPS)) in Q30, plus the interpolation guard entry
+extern const uint32_t pitch_frac_q30[PITCH_FRAC_STEPS + 1];
+// Velocity to pulse width scale, Q15
+extern const uint16_t velocity_q15[VEL_CURVE_COUNT][TABLE_NOTE_COUNT];
+// Frequency dependent on-time compensation, Q15
+extern const uint16_t note_width_q15[TABLE_NOTE_COUNT];
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
+
+#endif /* !TABLES_H */
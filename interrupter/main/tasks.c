@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file tasks.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "tasks.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <stdatomic.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define TAG "tasks"
+
+#define REPORT_MS (CONFIG_INTERRUPT_TASK_REPORT_S * 1000)
+#define LATENCY_WARN_US CONFIG_INTERRUPT_TASK_LATENCY_WARN_US
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+#define TASK_STACK(id, name, core, prio, stack, rt)                            \
+    static StackType_t stack_##id[(stack) / sizeof(StackType_t)];
+TASK_LIST(TASK_STACK)
+#undef TASK_STACK
+
+#define TASK_DESC(id, name_, core_, prio, stack, rt)                           \
+    [TASK_##id] = {.name = name_,                                              \
+                   .core = core_,                                              \
+                   .priority = prio,                                           \
+                   .stack_size = stack,                                        \
+                   .real_time = rt},
+static const task_desc_t descs[TASK_COUNT] = {TASK_LIST(TASK_DESC)};
+#undef TASK_DESC
+
+#define TASK_STACK_PTR(id, ...) [TASK_##id] = stack_##id,
+static StackType_t *const stacks[TASK_COUNT] = {TASK_LIST(TASK_STACK_PTR)};
+#undef TASK_STACK_PTR
+
+static StaticTask_t tcbs[TASK_COUNT];
+static TaskHandle_t handles[TASK_COUNT];
+
+// Written by the waker and the task, the worst taken by the monitor
+static volatile int64_t wake_us[TASK_COUNT];
+static atomic_uint worst_us[TASK_COUNT];
+static atomic_uint wakes[TASK_COUNT];
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static void tasks_monitor(void *arg)
+{
+    void (*report)(void) = arg;
+
+    while (1)
+    {
+        vTaskDelay(pdMS_TO_TICKS(REPORT_MS));
+
+        for (int id = 0; id < TASK_COUNT; id++)
+        {
+            if (!descs[id].real_time || handles[id] == NULL) continue;
+
+            task_latency_t latency;
+            task_take_latency(id, &latency);
+            if (latency.wakes == 0) continue;
+
+            // The output reports its pulse alarm, not the manual task
+            const char *name =
+                id == TASK_OUTPUT ? "pulse alarm" : descs[id].name;
+            if (latency.worst_us > LATENCY_WARN_US)
+                ESP_LOGW(TAG, "%s late by up to %lu us over %lu wakes", name,
+                         latency.worst_us, latency.wakes);
+            else
+                ESP_LOGI(TAG, "%s late by up to %lu us over %lu wakes", name,
+                         latency.worst_us, latency.wakes);
+        }
+
+        if (report) report();
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+const task_desc_t *task_desc(task_id_t id) { return &descs[id]; }
+
+TaskHandle_t task_start(task_id_t id, TaskFunction_t fn, void *arg)
+{
+    // The stack and control block are the task's own, never shared
+    configASSERT(handles[id] == NULL);
+
+    const task_desc_t *desc = &descs[id];
+    handles[id] = xTaskCreateStaticPinnedToCore(
+        fn, desc->name, desc->stack_size, arg, desc->priority, stacks[id],
+        &tcbs[id], desc->core);
+
+    ESP_LOGD(TAG, "%s on core %d, priority %u, %lu bytes", desc->name,
+             desc->core, desc->priority, desc->stack_size);
+    return handles[id];
+}
+
+void IRAM_ATTR task_wake_stamp(task_id_t id)
+{
+    wake_us[id] = esp_timer_get_time();
+}
+
+void task_woken(task_id_t id)
+{
+    int64_t at = wake_us[id];
+    if (at == 0) return; // Not woken by a stamped request
+
+    wake_us[id] = 0;
+    task_late(id, esp_timer_get_time() - at);
+}
+
+void IRAM_ATTR task_late(task_id_t id, uint32_t us)
+{
+    // Only the task itself, or its ISR, raises its worst
+    if (us > atomic_load(&worst_us[id])) atomic_store(&worst_us[id], us);
+    atomic_fetch_add(&wakes[id], 1);
+}
+
+void task_take_latency(task_id_t id, task_latency_t *latency)
+{
+    latency->worst_us = atomic_exchange(&worst_us[id], 0);
+    latency->wakes = atomic_exchange(&wakes[id], 0);
+}
+
+void tasks_monitor_init(void (*report)(void))
+{
+    if (REPORT_MS == 0) return;
+    task_start(TASK_MONITOR, tasks_monitor, report);
+}
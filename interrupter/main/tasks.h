@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file tasks.h
+ * @brief Table of the application tasks: core, priority and stack of each
+ *
+ * Every task is one line of TASK_LIST, its placement read from the Tasks
+ * menu of the configuration. Stacks and control blocks are static, sized by
+ * the table, so starting a task cannot fail on a fragmented heap.
+ *
+ * Real-time output and mixing run on core 1, USB, serial MIDI, the screen
+ * and logging on core 0. Interrupts are allocated on the core that installs
+ * them: app_main runs on core 1 for the output timers, the init tasks on
+ * core 0 for USB, UART and I2C.
+ *
+ * Real-time tasks report how late they run once due: stamped where the wake
+ * is requested and checked by the task when it runs. The output is measured
+ * on the pulse timer alarm instead, each MIDI mode pulse against the time
+ * it was due; the manual mode task runs on the tick and is not measured.
+ * The worst delay is logged by the monitor every
+ * CONFIG_INTERRUPT_TASK_REPORT_S.
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+#ifndef TASKS_H
+#define TASKS_H
+
+// clang-format off
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "sdkconfig.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define TASK_UI_CORE CONFIG_INTERRUPT_TASK_MENU_CORE
+#define TASK_USB_CORE CONFIG_INTERRUPT_TASK_USB_HOST_CORE
+
+// X(id, name, core, priority, stack bytes, real-time)
+#define TASK_LIST(X)                                                           \
+    /* Core 1: output and mixing */                                            \
+    X(OUTPUT, "low_pwm_task", CONFIG_INTERRUPT_TASK_OUTPUT_CORE,               \
+      CONFIG_INTERRUPT_TASK_OUTPUT_PRIO, CONFIG_INTERRUPT_TASK_OUTPUT_STACK,   \
+      true)                                                                    \
+    X(CLIP, "clip_task", CONFIG_INTERRUPT_TASK_CLIP_CORE,                      \
+      CONFIG_INTERRUPT_TASK_CLIP_PRIO, CONFIG_INTERRUPT_TASK_CLIP_STACK, true) \
+    X(CONTROL, "synth_task", CONFIG_INTERRUPT_TASK_CONTROL_CORE,               \
+      CONFIG_INTERRUPT_TASK_CONTROL_PRIO, CONFIG_INTERRUPT_TASK_CONTROL_STACK, \
+      true)                                                                    \
+    /* Core 0: MIDI input */                                                   \
+    X(MIDI_UART, "midi_uart", CONFIG_INTERRUPT_TASK_MIDI_UART_CORE,            \
+      CONFIG_INTERRUPT_TASK_MIDI_UART_PRIO,                                    \
+      CONFIG_INTERRUPT_TASK_MIDI_UART_STACK, false)                            \
+    X(USB_HOST, "usb_host", CONFIG_INTERRUPT_TASK_USB_HOST_CORE,               \
+      CONFIG_INTERRUPT_TASK_USB_HOST_PRIO,                                     \
+      CONFIG_INTERRUPT_TASK_USB_HOST_STACK, false)                             \
+    X(USB_CLIENT, "usb_client", CONFIG_INTERRUPT_TASK_USB_CLIENT_CORE,         \
+      CONFIG_INTERRUPT_TASK_USB_CLIENT_PRIO,                                   \
+      CONFIG_INTERRUPT_TASK_USB_CLIENT_STACK, false)                           \
+    /* Core 0: screen and knob */                                              \
+    X(MENU, "menu_task", CONFIG_INTERRUPT_TASK_MENU_CORE,                      \
+      CONFIG_INTERRUPT_TASK_MENU_PRIO, CONFIG_INTERRUPT_TASK_MENU_STACK,       \
+      false)                                                                   \
+    X(VIEW, "view_task", CONFIG_INTERRUPT_TASK_VIEW_CORE,                      \
+      CONFIG_INTERRUPT_TASK_VIEW_PRIO, CONFIG_INTERRUPT_TASK_VIEW_STACK,       \
+      false)                                                                   \
+    X(FLUSH, "display_task", CONFIG_INTERRUPT_TASK_FLUSH_CORE,                 \
+      CONFIG_INTERRUPT_TASK_FLUSH_PRIO, CONFIG_INTERRUPT_TASK_FLUSH_STACK,     \
+      false)                                                                   \
+    X(MONITOR, "task_monitor", CONFIG_INTERRUPT_TASK_MONITOR_CORE,             \
+      CONFIG_INTERRUPT_TASK_MONITOR_PRIO, CONFIG_INTERRUPT_TASK_MONITOR_STACK, \
+      false)                                                                   \
+    /* Boot only, they install the drivers on their core */                    \
+    X(UI_INIT, "ui_init", TASK_UI_CORE, CONFIG_INTERRUPT_TASK_UI_INIT_PRIO,    \
+      CONFIG_INTERRUPT_TASK_UI_INIT_STACK, false)                              \
+    X(USB_INIT, "usb_init", TASK_USB_CORE,                                     \
+      CONFIG_INTERRUPT_TASK_USB_INIT_PRIO,                                     \
+      CONFIG_INTERRUPT_TASK_USB_INIT_STACK, false)
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+#define TASK_ENUM_ID(id, ...) TASK_##id,
+typedef enum
+{
+    TASK_LIST(TASK_ENUM_ID)
+    TASK_COUNT
+} task_id_t;
+#undef TASK_ENUM_ID
+
+typedef struct
+{
+    const char *name;
+    int core;
+    UBaseType_t priority;
+    uint32_t stack_size; // Bytes
+    bool real_time;
+} task_desc_t;
+
+typedef struct
+{
+    uint32_t worst_us; // Since the last report
+    uint32_t wakes;
+} task_latency_t;
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+const task_desc_t *task_desc(task_id_t id);
+
+// Once per task, on its static stack
+TaskHandle_t task_start(task_id_t id, TaskFunction_t fn, void *arg);
+
+// Where the wake of a real-time task is requested, ISR safe
+void task_wake_stamp(task_id_t id);
+// In the task once it runs, counts the delay since the stamp
+void task_woken(task_id_t id);
+// Late by an amount the caller measured, ISR safe
+void task_late(task_id_t id, uint32_t us);
+
+// Worst delay since the last call, which starts a new window
+void task_take_latency(task_id_t id, task_latency_t *latency);
+
+// Logs the real-time tasks every CONFIG_INTERRUPT_TASK_REPORT_S, 0 is off,
+// then calls report, if any, from the monitor task
+void tasks_monitor_init(void (*report)(void));
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
+
+#endif /* !TASKS_H */
@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file telemetry.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "telemetry.h"
+#include "audio.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "output.h"
+#include "voice.h"
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define INPUT_FULL_SCALE 2048
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+typedef struct
+{
+    int64_t time_us;
+    output_counters_t output;
+    voice_counters_t voice;
+    audio_input_counters_t input;
+    uint32_t idle_us[TELEMETRY_CORES];
+} snapshot_t;
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static snapshot_t last = {0};
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static uint8_t telemetry_pct(uint64_t part, uint64_t whole)
+{
+    if (whole == 0) return 0;
+    return part >= whole ? 100 : part * 100 / whole;
+}
+
+static void telemetry_output(const snapshot_t *now, uint32_t elapsed_us,
+                             telemetry_t *out)
+{
+    const output_counters_t *o = &now->output;
+
+    if (!output_is_armed()) return; // Nothing reaches the pin
+
+    if (o->train_period_tick)
+    {
+        // Repeated by the peripheral, nothing is counted
+        out->prf_hz = OUTPUT_TICK_HZ / o->train_period_tick;
+        out->duty_permille =
+            (uint64_t)o->train_width_tick * 1000 / o->train_period_tick;
+    }
+    else if (o->pulses != last.output.pulses)
+    {
+        uint32_t pulses = o->pulses - last.output.pulses;
+        uint32_t on_tick = o->on_tick - last.output.on_tick;
+        out->prf_hz = (uint64_t)pulses * 1000000 / elapsed_us;
+        out->duty_permille = (uint64_t)on_tick * 1000000000 /
+                             ((uint64_t)OUTPUT_TICK_HZ * elapsed_us);
+    }
+    else if (o->duty_updates != last.output.duty_updates)
+    {
+        uint32_t updates = o->duty_updates - last.output.duty_updates;
+        uint32_t sum = o->duty_sum - last.output.duty_sum;
+        out->duty_permille = (uint64_t)sum * 1000 / (255ULL * updates);
+    }
+
+    if (out->duty_permille > 1000) out->duty_permille = 1000;
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+void telemetry_sample(telemetry_t *out)
+{
+    snapshot_t now = {0};
+    now.time_us = esp_timer_get_time();
+    now.output = output_counters;
+    voice_get_counters(&now.voice);
+    audio_get_input_counters(&now.input);
+#if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+    // Run time is counted in esp_timer microseconds
+    for (int core = 0; core < TELEMETRY_CORES; core++)
+        now.idle_us[core] =
+            ulTaskGetRunTimeCounter(xTaskGetIdleTaskHandleForCore(core));
+#endif
+
+    memset(out, 0, sizeof(*out));
+    uint32_t elapsed_us = now.time_us - last.time_us;
+    if (elapsed_us == 0) return;
+
+    telemetry_output(&now, elapsed_us, out);
+
+    out->voices = voice_active_count();
+    out->limit_pct = telemetry_pct(now.voice.limited - last.voice.limited,
+                                   now.voice.voice_ticks -
+                                       last.voice.voice_ticks);
+
+    uint32_t samples = now.input.samples - last.input.samples;
+    uint32_t level = now.input.level_sum - last.input.level_sum;
+    out->input_pct = telemetry_pct(level, (uint64_t)samples * INPUT_FULL_SCALE);
+
+#if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+    for (int core = 0; core < TELEMETRY_CORES; core++)
+    {
+        uint32_t idle = now.idle_us[core] - last.idle_us[core];
+        out->cpu_pct[core] = 100 - telemetry_pct(idle, elapsed_us);
+    }
+#endif
+
+    last = now;
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file telemetry.h
+ * @brief Live figures for the telemetry screen
+ *
+ * Built from free running counters that the output, voice and audio input
+ * paths increment as they go, and from the FreeRTOS idle time of each core.
+ * A sample is the difference with the previous one, over the time between
+ * the two: sampling at the frame rate gives frame averages. Nothing is
+ * locked, a counter read while it moves is off by one event.
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+// clang-format off
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "sdkconfig.h"
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define TELEMETRY_CORES CONFIG_FREERTOS_NUMBER_OF_CORES
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+typedef struct
+{
+    uint16_t duty_permille; // Average on time at the pin
+    uint32_t prf_hz;        // Pulses at the pin, 0 for the audio carrier
+    uint8_t voices;         // Sounding now
+    uint8_t limit_pct;      // Voice ticks clamped by the duty limit
+    uint8_t cpu_pct[TELEMETRY_CORES];
+    uint8_t input_pct; // Mean audio input level
+} telemetry_t;
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+void telemetry_sample(telemetry_t *telemetry);
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
+
+#endif /* !TELEMETRY_H */
@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file timeline.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "timeline.h"
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static inline bool read_varint(tl_reader_t *r, uint32_t *value)
+{
+    uint32_t v = 0;
+
+    for (int shift = 0; shift < 35 && r->pos < r->end; shift += 7)
+    {
+        uint8_t b = *r->pos++;
+        v |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80))
+        {
+            *value = v;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void tl_seek_block(tl_reader_t *r, uint32_t block)
+{
+    const tl_header_t *hdr = r->hdr;
+    const uint8_t *base = r->data + hdr->data_offset;
+
+    r->block = block;
+    r->pos = base + r->index[block].offset;
+    r->end = block + 1 < hdr->block_count ? base + r->index[block + 1].offset
+                                          : base + hdr->data_size;
+    r->time_us = r->index[block].time_us;
+
+    uint32_t first = block * hdr->block_records;
+    r->left = hdr->record_count - first < hdr->block_records
+                  ? hdr->record_count - first
+                  : hdr->block_records;
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+bool tl_open(tl_reader_t *r, const uint8_t *data, size_t size)
+{
+    const tl_header_t *hdr = (const tl_header_t *)data;
+
+    if (size < sizeof(tl_header_t)) return false;
+    if (hdr->magic != TL_MAGIC || hdr->version != TL_VERSION) return false;
+    if (hdr->block_records == 0 || hdr->index_offset % 4 != 0) return false;
+    if (hdr->index_offset + (uint64_t)hdr->block_count * sizeof(tl_block_t) >
+        size)
+        return false;
+    if ((uint64_t)hdr->data_offset + hdr->data_size > size) return false;
+    if ((uint64_t)hdr->block_count * hdr->block_records < hdr->record_count)
+        return false;
+
+    const tl_block_t *index = (const tl_block_t *)(data + hdr->index_offset);
+    for (uint32_t i = 0; i < hdr->block_count; i++)
+    {
+        if (index[i].offset > hdr->data_size) return false;
+        if (i > 0 && index[i].offset < index[i - 1].offset) return false;
+    }
+
+    r->data = data;
+    r->hdr = hdr;
+    r->index = index;
+
+    if (hdr->block_count == 0)
+    {
+        r->pos = r->end = NULL;
+        r->left = 0;
+        r->block = 0;
+        r->time_us = 0;
+        return true;
+    }
+
+    tl_seek_block(r, 0);
+    return true;
+}
+
+bool tl_seek(tl_reader_t *r, uint32_t time_us)
+{
+    uint32_t lo = 0;
+    uint32_t hi = r->hdr->block_count;
+
+    if (hi == 0) return false;
+
+    // Last block starting at or before time_us
+    while (hi - lo > 1)
+    {
+        uint32_t mid = (lo + hi) / 2;
+        if (r->index[mid].time_us <= time_us)
+            lo = mid;
+        else
+            hi = mid;
+    }
+    tl_seek_block(r, lo);
+
+    // Then skip the records before time_us within the block
+    while (1)
+    {
+        tl_reader_t save = *r;
+        tl_pulse_t pulse;
+        if (!tl_next(r, &pulse)) return false;
+        if (pulse.time_us >= time_us)
+        {
+            *r = save;
+            return true;
+        }
+    }
+}
+
+bool tl_next(tl_reader_t *r, tl_pulse_t *pulse)
+{
+    if (r->left == 0)
+    {
+        if (r->block + 1 >= r->hdr->block_count) return false;
+        tl_seek_block(r, r->block + 1);
+        if (r->left == 0) return false;
+    }
+
+    uint32_t head, width;
+    if (!read_varint(r, &head) || !read_varint(r, &width))
+    {
+        // Truncated image, stop there
+        r->left = 0;
+        r->block = r->hdr->block_count;
+        return false;
+    }
+
+    r->left--;
+    r->time_us += head >> TL_OUTPUT_BITS;
+
+    pulse->time_us = r->time_us;
+    pulse->output = head & (TL_MAX_OUTPUTS - 1);
+    pulse->width_tick = width > UINT16_MAX ? UINT16_MAX : (uint16_t)width;
+
+    return true;
+}
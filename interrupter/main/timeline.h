@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file timeline.h
+ * @brief Precompiled pulse timeline format and decoder
+ *
+ * Shared by the firmware and the host renderer (tools/pulsetl). An image is
+ * laid out as:
+ *
+ *   tl_header_t | tl_block_t index[block_count] | record data
+ *
+ * Records are delta encoded as two LEB128 varints:
+ *   (delta_us << TL_OUTPUT_BITS) | output, width_tick
+ * The first record of a block is relative to the block time from the
+ * index, so decoding can start at any block. All fields are little endian.
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+#ifndef TIMELINE_H
+#define TIMELINE_H
+
+// clang-format off
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define TL_MAGIC 0x314C5450 // "PTL1"
+#define TL_VERSION 1
+#define TL_OUTPUT_BITS 2
+#define TL_MAX_OUTPUTS (1 << TL_OUTPUT_BITS)
+#define TL_BLOCK_RECORDS 256 // Default records per block
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint8_t output_count;
+    uint8_t reserved;
+    uint32_t tick_hz;       // Width unit
+    uint32_t duration_us;
+    uint32_t record_count;
+    uint32_t block_count;
+    uint32_t block_records; // Records per block, the last one may be shorter
+    uint32_t index_offset;  // From the start of the image
+    uint32_t data_offset;
+    uint32_t data_size;
+} tl_header_t;
+
+typedef struct
+{
+    uint32_t time_us; // Time the first record of the block is relative to
+    uint32_t offset;  // From data_offset
+} tl_block_t;
+
+typedef struct
+{
+    uint32_t time_us;
+    uint16_t width_tick;
+    uint8_t output;
+} tl_pulse_t;
+
+typedef struct
+{
+    const uint8_t *data;
+    const tl_header_t *hdr;
+    const tl_block_t *index;
+    const uint8_t *pos;
+    const uint8_t *end;
+    uint32_t block;
+    uint32_t left;    // Records left in the current block
+    uint32_t time_us; // Time of the last decoded record
+} tl_reader_t;
+
+_Static_assert(sizeof(tl_header_t) == 40, "tl_header_t layout");
+_Static_assert(sizeof(tl_block_t) == 8, "tl_block_t layout");
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+bool tl_open(tl_reader_t *r, const uint8_t *data, size_t size);
+bool tl_seek(tl_reader_t *r, uint32_t time_us);
+bool tl_next(tl_reader_t *r, tl_pulse_t *pulse);
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
+
+#endif /* !TIMELINE_H */
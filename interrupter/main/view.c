@@ -0,0 +1,354 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file view.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "view.h"
+#include "audio.h"
+#include "display.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "lvgl.h"
+#include "scope.h"
+#include "tasks.h"
+#include "ui/ui.h"
+#include "voice.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+// Telemetry screen, two columns of bars under their value
+#define CELL_W 64
+#define CELL_H 16
+#define CELL_ROWS 4
+#define BAR_Y 10
+#define BAR_H 5
+
+// Scope screen
+#define SPECTRUM_MS 100
+#define SPECTRUM_FRAMES \
+    (SPECTRUM_MS > VIEW_FRAME_MS ? SPECTRUM_MS / VIEW_FRAME_MS : 1)
+#define WAVE_RANGE 2048
+
+_Static_assert(TELEMETRY_CORES == 2, "One CPU bar per core of the ESP32-S3");
+_Static_assert(SCOPE_SAMPLES <= AUDIO_INPUT_RING, "Scope reads past the ring");
+_Static_assert(sizeof(lv_coord_t) == sizeof(int16_t),
+               "Scope points are charted");
+
+#define TAG "view"
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+typedef enum
+{
+    BAR_DUTY,
+    BAR_PRF,
+    BAR_VOICES,
+    BAR_LIMIT,
+    BAR_CPU0,
+    BAR_CPU1,
+    BAR_INPUT,
+    BAR_COUNT
+} bar_t;
+
+typedef struct
+{
+    const char *name;
+    const char *unit;
+    int32_t max;      // Full bar
+    uint8_t decimals; // Of the value, 1 shows tenths
+} bar_def_t;
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static const char *mode_names[] = {"MAN", "AUD", "MIDI", "CLIP"};
+
+static const bar_def_t bar_defs[BAR_COUNT] = {
+    [BAR_DUTY] = {"DTY", "%", 500, 1}, // Permille, full at 50 %
+    [BAR_PRF] = {"PRF", "Hz", 2000, 0},
+    [BAR_VOICES] = {"VOI", "", VOICE_COUNT, 0},
+    [BAR_LIMIT] = {"LIM", "%", 100, 0},
+    [BAR_CPU0] = {"CP0", "%", 100, 0},
+    [BAR_CPU1] = {"CP1", "%", 100, 0},
+    [BAR_INPUT] = {"IN", "%", 100, 0},
+};
+
+static lv_obj_t *screens[VIEW_SCREEN_COUNT];
+static lv_obj_t *bar_txt[BAR_COUNT];
+static lv_obj_t *bars[BAR_COUNT];
+
+// Charts read the points in place
+static lv_obj_t *wave_chart;
+static lv_obj_t *spectrum_chart;
+static int16_t scope_samples[SCOPE_SAMPLES];
+static lv_coord_t wave_points[SCOPE_POINTS];
+static lv_coord_t spectrum_levels[SCOPE_BANDS];
+
+static view_state_t published;
+static atomic_uint published_seq = 0; // Odd while a publish is in progress
+
+static lv_obj_t *slot_name_txt[VIEW_SLOTS];
+static lv_obj_t *slot_val_txt[VIEW_SLOTS];
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+// False when nothing new was published, or when the copy may be torn
+static bool view_read(view_state_t *state, unsigned *seq)
+{
+    unsigned start = atomic_load_explicit(&published_seq, memory_order_acquire);
+    if ((start & 1) || start == *seq) return false;
+
+    *state = published;
+    atomic_thread_fence(memory_order_acquire);
+    if (atomic_load_explicit(&published_seq, memory_order_relaxed) != start)
+        return false;
+
+    *seq = start;
+    return true;
+}
+
+// Setting the same text or flag again would still redraw the object
+static void view_set_text(lv_obj_t *label, const char *text)
+{
+    if (strcmp(lv_label_get_text(label), text) != 0)
+        lv_label_set_text(label, text);
+}
+
+static void view_set_hidden(lv_obj_t *obj, bool hidden)
+{
+    if (lv_obj_has_flag(obj, LV_OBJ_FLAG_HIDDEN) == hidden) return;
+    if (hidden)
+        lv_obj_add_flag(obj, LV_OBJ_FLAG_HIDDEN);
+    else
+        lv_obj_clear_flag(obj, LV_OBJ_FLAG_HIDDEN);
+}
+
+static void view_create_telemetry(void)
+{
+    lv_obj_t *screen = lv_obj_create(NULL);
+    screens[VIEW_TELEMETRY] = screen;
+
+    for (int i = 0; i < BAR_COUNT; i++)
+    {
+        lv_coord_t x = i / CELL_ROWS * CELL_W;
+        lv_coord_t y = i % CELL_ROWS * CELL_H;
+
+        lv_obj_t *txt = lv_label_create(screen);
+        lv_obj_set_pos(txt, x + 1, y);
+        lv_obj_set_style_text_font(txt, &lv_font_montserrat_8,
+                                   LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_label_set_text(txt, bar_defs[i].name);
+        bar_txt[i] = txt;
+
+        lv_obj_t *bar = lv_bar_create(screen);
+        lv_obj_set_pos(bar, x + 1, y + BAR_Y);
+        lv_obj_set_size(bar, CELL_W - 4, BAR_H);
+        lv_bar_set_range(bar, 0, bar_defs[i].max);
+        bars[i] = bar;
+    }
+}
+
+static lv_obj_t *view_create_chart(lv_obj_t *screen, lv_chart_type_t type,
+                                   lv_coord_t *points, uint16_t count,
+                                   lv_coord_t min, lv_coord_t max)
+{
+    lv_obj_t *chart = lv_chart_create(screen);
+    lv_obj_set_pos(chart, 0, 0);
+    lv_obj_set_size(chart, DISPLAY_H_RES, DISPLAY_V_RES);
+    lv_obj_set_style_pad_all(chart, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_border_width(chart, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_radius(chart, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_size(chart, 0, LV_PART_INDICATOR | LV_STATE_DEFAULT);
+    lv_chart_set_div_line_count(chart, 0, 0);
+    lv_chart_set_type(chart, type);
+    lv_chart_set_point_count(chart, count);
+    lv_chart_set_range(chart, LV_CHART_AXIS_PRIMARY_Y, min, max);
+
+    lv_chart_series_t *series = lv_chart_add_series(
+        chart, lv_color_white(), LV_CHART_AXIS_PRIMARY_Y);
+    lv_chart_set_ext_y_array(chart, series, points);
+    return chart;
+}
+
+static void view_create_scope(void)
+{
+    lv_obj_t *screen = lv_obj_create(NULL);
+    screens[VIEW_SCOPE] = screen;
+
+    wave_chart = view_create_chart(screen, LV_CHART_TYPE_LINE, wave_points,
+                                   SCOPE_POINTS, -WAVE_RANGE, WAVE_RANGE - 1);
+    spectrum_chart =
+        view_create_chart(screen, LV_CHART_TYPE_BAR, spectrum_levels,
+                          SCOPE_BANDS, 0, SCOPE_LEVEL_MAX);
+    lv_obj_add_flag(spectrum_chart, LV_OBJ_FLAG_HIDDEN);
+}
+
+// Waveform every frame, spectrum every SPECTRUM_FRAMES
+static void view_update_scope(bool spectrum, uint32_t frame)
+{
+    if (spectrum)
+    {
+        if (frame % SPECTRUM_FRAMES) return;
+        audio_get_input_samples(scope_samples, SCOPE_FFT_SIZE);
+        scope_spectrum(scope_samples, spectrum_levels);
+        lv_chart_refresh(spectrum_chart);
+    }
+    else
+    {
+        audio_get_input_samples(scope_samples, SCOPE_SAMPLES);
+        scope_waveform(scope_samples, wave_points);
+        lv_chart_refresh(wave_chart);
+    }
+}
+
+static void view_apply_telemetry(const telemetry_t *t)
+{
+    const int32_t values[BAR_COUNT] = {
+        [BAR_DUTY] = t->duty_permille, [BAR_PRF] = t->prf_hz,
+        [BAR_VOICES] = t->voices,      [BAR_LIMIT] = t->limit_pct,
+        [BAR_CPU0] = t->cpu_pct[0],    [BAR_CPU1] = t->cpu_pct[1],
+        [BAR_INPUT] = t->input_pct,
+    };
+    char buf[20];
+
+    for (int i = 0; i < BAR_COUNT; i++)
+    {
+        const bar_def_t *def = &bar_defs[i];
+        int32_t value = values[i];
+
+        if (def->decimals)
+            snprintf(buf, sizeof(buf), "%s %ld.%ld%s", def->name,
+                     (long)value / 10, (long)value % 10, def->unit);
+        else
+            snprintf(buf, sizeof(buf), "%s %ld%s", def->name, (long)value,
+                     def->unit);
+        view_set_text(bar_txt[i], buf);
+
+        if (value > def->max) value = def->max;
+        if (lv_bar_get_value(bars[i]) != value)
+            lv_bar_set_value(bars[i], value, LV_ANIM_OFF);
+    }
+}
+
+static void view_apply(const view_state_t *state)
+{
+    char buf[12];
+
+    if (lv_scr_act() != screens[state->screen])
+        lv_scr_load(screens[state->screen]);
+    if (state->screen == VIEW_TELEMETRY)
+    {
+        view_apply_telemetry(&state->telemetry);
+        return;
+    }
+    if (state->screen == VIEW_SCOPE)
+    {
+        view_set_hidden(wave_chart, state->spectrum);
+        view_set_hidden(spectrum_chart, !state->spectrum);
+        return;
+    }
+
+    for (int slot = 0; slot < VIEW_SLOTS; slot++)
+    {
+        const char *name = state->names[slot];
+        bool used = name[0] != '\0';
+
+        snprintf(buf, sizeof(buf), slot == state->selected ? ">%.3s<" : "%.3s",
+                 name);
+        view_set_text(slot_name_txt[slot], buf);
+        snprintf(buf, sizeof(buf), "%d", state->values[slot]);
+        view_set_text(slot_val_txt[slot], used ? buf : "");
+    }
+
+    bool known = state->mode < sizeof(mode_names) / sizeof(mode_names[0]);
+    view_set_text(objects.state, known ? mode_names[state->mode] : "?");
+    view_set_text(objects.con_state, state->midi_connected ? "USB" : "");
+    view_set_hidden(objects.spark, !state->armed);
+}
+
+static void view_task(void *arg)
+{
+    unsigned seq = 0; // Nothing shown before the first publish
+    view_state_t state = {0};
+    uint32_t frame = 0;
+    TickType_t wake = xTaskGetTickCount();
+    TickType_t last = wake;
+
+    while (1)
+    {
+        view_state_t next;
+        if (view_read(&next, &seq))
+        {
+            state = next;
+            view_apply(&state);
+        }
+        if (state.screen == VIEW_SCOPE)
+            view_update_scope(state.spectrum, frame);
+        frame++;
+
+        TickType_t now = xTaskGetTickCount();
+        lv_tick_inc((now - last) * portTICK_PERIOD_MS);
+        last = now;
+        lv_timer_handler();
+
+        vTaskDelayUntil(&wake, pdMS_TO_TICKS(VIEW_FRAME_MS));
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+void view_init(esp_lcd_panel_handle_t panel)
+{
+    lv_init();
+    lv_disp_t *disp = display_init(panel);
+    lv_disp_set_rotation(disp, LV_DISP_ROT_NONE);
+    // Frames are paced by the task, not by LVGL's refresh period
+    lv_timer_set_period(disp->refr_timer, VIEW_FRAME_MS);
+
+    ui_init();
+    slot_name_txt[0] = objects.dc_txt;
+    slot_val_txt[0] = objects.dc_val_txt;
+    slot_name_txt[1] = objects.prf_txt;
+    slot_val_txt[1] = objects.prf_val_txt;
+    screens[VIEW_MAIN] = objects.main;
+    view_create_telemetry();
+    view_create_scope();
+
+    task_start(TASK_VIEW, view_task, NULL);
+
+    ESP_LOGI(TAG, "Up to %d fps on core %d", CONFIG_INTERRUPT_UI_FPS,
+             task_desc(TASK_VIEW)->core);
+}
+
+void view_publish(const view_state_t *state)
+{
+    // The single writer can read its own copy without the counter
+    if (memcmp(&published, state, sizeof(*state)) == 0) return;
+
+    unsigned seq = atomic_load_explicit(&published_seq, memory_order_relaxed);
+    atomic_store_explicit(&published_seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    published = *state;
+    atomic_store_explicit(&published_seq, seq + 2, memory_order_release);
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file view.h
+ * @brief Screen rendering task
+ *
+ * The only task touching LVGL. It renders at a capped frame rate from a
+ * snapshot of the state to show, published by the menu task under a
+ * sequence counter: the writer never waits, and the reader skips a frame
+ * instead of waiting when it catches a publish halfway.
+ *
+ * Three screens: the ranges of the menu, the telemetry as bar graphs, and
+ * the audio input as a waveform or a spectrum. The scope is drawn from the
+ * input samples by this task, the spectrum at a lower rate than frames.
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+#ifndef VIEW_H
+#define VIEW_H
+
+// clang-format off
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "esp_lcd_panel_ops.h"
+#include "pwm.h"
+#include "sdkconfig.h"
+#include "telemetry.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define VIEW_SLOTS 2 // Ranges on screen at once
+#define VIEW_FRAME_MS (1000 / CONFIG_INTERRUPT_UI_FPS)
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+typedef enum
+{
+    VIEW_MAIN,
+    VIEW_TELEMETRY,
+    VIEW_SCOPE,
+    VIEW_SCREEN_COUNT
+} view_screen_t;
+
+typedef struct
+{
+    view_screen_t screen;
+    char names[VIEW_SLOTS][4]; // Empty for an unused slot
+    int16_t values[VIEW_SLOTS];
+    uint8_t selected; // Highlighted slot
+    pwm_mode_t mode;
+    bool armed;
+    bool midi_connected;
+    telemetry_t telemetry; // Telemetry screen only
+    bool spectrum;         // Scope screen shows the spectrum
+} view_state_t;
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+void view_init(esp_lcd_panel_handle_t panel);
+
+// Single writer, never blocks
+void view_publish(const view_state_t *state);
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
+
+#endif /* !VIEW_H */
@@ -0,0 +1,462 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file voice.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "voice.h"
+#include "tables.h"
+#include <math.h>
+#include <stdatomic.h>
+#include <stddef.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define PITCH_MAX ((127 + 24) << VOICE_PITCH_SHIFT)
+#define MODULATION_MAX 127
+
+#define SINE_TABLE_SIZE 256
+
+#define CC_MODULATION 1
+#define CC_PORTAMENTO_TIME 5
+#define CC_PORTAMENTO 65
+#define CC_ALL_SOUND_OFF 120
+#define CC_ALL_NOTES_OFF 123
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static voice_t voices[VOICE_COUNT];
+
+static int16_t sine_table[SINE_TABLE_SIZE];
+
+static uint32_t control_rate = 1000;
+static uint32_t age_counter = 0;
+
+static int32_t bend_pitch = 0;      // Q16 semitones
+static uint8_t modulation = 0;
+static uint32_t lfo_phase = 0;
+static uint32_t lfo_sync_inc = 0;   // 0 = patch rate
+static uint32_t glide_ticks = 0;    // 0 = portamento off
+static int32_t last_pitch = -1;
+static uint16_t portamento_ms = CONFIG_INTERRUPT_PORTAMENTO_MS;
+static bool portamento_on = CONFIG_INTERRUPT_PORTAMENTO_MS > 0;
+
+// Single pointer, swapped atomically on program change
+static voice_patch_t default_patch;
+static const voice_patch_t *patch = &default_patch;
+static const voice_patch_t *patches = NULL;
+static uint8_t patch_count = 0;
+
+static voice_counters_t counters = {0};
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static voice_t *voice_alloc(void)
+{
+    voice_t *oldest = NULL;
+    voice_t *oldest_released = NULL;
+
+    // Voices above the patch polyphony only finish their release
+    for (int i = 0; i < patch->polyphony; i++)
+    {
+        voice_t *v = &voices[i];
+        if (v->note == VOICE_NOTE_NONE) return v;
+        if (oldest == NULL || v->age < oldest->age) oldest = v;
+        if (!v->gate &&
+            (oldest_released == NULL || v->age < oldest_released->age))
+            oldest_released = v;
+    }
+
+    // Steal a voice in release first, then the oldest held one
+    return oldest_released ? oldest_released : oldest;
+}
+
+// The pulse ISR may run on another core, or in the middle of the update
+static void voice_publish(voice_t *v, uint32_t period_q8, uint16_t width_tick)
+{
+    v->seq++;
+    atomic_thread_fence(memory_order_release);
+    v->period_q8 = period_q8;
+    v->width_tick = width_tick;
+    atomic_thread_fence(memory_order_release);
+    v->seq++;
+}
+
+// Keeps the last whole pair when the control task is halfway through one
+static void IRAM_ATTR voice_read(voice_t *v)
+{
+    uint32_t seq = v->seq;
+    if (seq & 1) return;
+
+    atomic_thread_fence(memory_order_acquire);
+    uint32_t period_q8 = v->period_q8;
+    uint16_t width_tick = v->width_tick;
+    atomic_thread_fence(memory_order_acquire);
+    if (v->seq != seq) return;
+
+    v->pulse_period_q8 = period_q8;
+    v->pulse_width_tick = width_tick;
+}
+
+static void voice_silence(voice_t *v)
+{
+    voice_publish(v, 0, 0);
+    v->gate = false;
+    v->note = VOICE_NOTE_NONE;
+    env_reset(&v->env);
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+void voice_init(uint32_t control_rate_hz)
+{
+    control_rate = control_rate_hz;
+
+    for (int i = 0; i < SINE_TABLE_SIZE; i++)
+    {
+        sine_table[i] =
+            (int16_t)lrint(32767.0 * sin(2.0 * M_PI * i / SINE_TABLE_SIZE));
+    }
+
+    for (int i = 0; i < VOICE_COUNT; i++)
+    {
+        voice_silence(&voices[i]);
+        voices[i].next_q8 = 0;
+        voices[i].pulse_period_q8 = 0;
+        voices[i].pulse_width_tick = 0;
+    }
+
+    bank_preset_t preset;
+    bank_preset_default(&preset);
+    voice_patch_compile(&default_patch, &preset);
+    patch = &default_patch;
+
+    voice_set_pitch_bend(0);
+    voice_set_modulation(0);
+    voice_set_portamento(portamento_ms, portamento_on);
+}
+
+void voice_note_on(uint8_t channel, uint8_t note, uint8_t velocity)
+{
+    voice_t *v = voice_alloc();
+
+    v->note = note;
+    v->channel = channel;
+    v->velocity = velocity;
+    v->gate = true;
+    v->age = ++age_counter;
+    v->target_pitch = (int32_t)note << VOICE_PITCH_SHIFT;
+    const voice_patch_t *p = patch;
+    v->base_width = (uint16_t)(((((uint32_t)p->pd_max *
+                                  velocity_q15[p->vel_curve][velocity]) >>
+                                 15) *
+                                note_width_q15[note]) >>
+                               15);
+
+    if (glide_ticks > 0 && last_pitch >= 0)
+    {
+        // Glide from the previous note in a constant time
+        v->pitch = last_pitch;
+        v->glide_ticks = glide_ticks;
+        v->glide_step = (v->target_pitch - v->pitch) / (int32_t)glide_ticks;
+    }
+    else
+    {
+        v->pitch = v->target_pitch;
+        v->glide_ticks = 0;
+    }
+
+    last_pitch = v->target_pitch;
+    env_gate_on(&v->env);
+    v->retrigger = true;
+}
+
+void voice_note_off(uint8_t channel, uint8_t note)
+{
+    for (int i = 0; i < VOICE_COUNT; i++)
+    {
+        voice_t *v = &voices[i];
+        if (v->gate && v->note == note && v->channel == channel)
+        {
+            // Keeps sounding until the release is over
+            v->gate = false;
+            env_gate_off(&v->env);
+        }
+    }
+}
+
+void voice_all_off(void)
+{
+    for (int i = 0; i < VOICE_COUNT; i++) voice_silence(&voices[i]);
+    last_pitch = -1;
+}
+
+void voice_handle_message(const midi_message_t *msg)
+{
+    switch (msg->type)
+    {
+    case MIDI_MSG_NOTE:
+        if (msg->state)
+            voice_note_on(msg->channel, msg->note, msg->velocity);
+        else
+            voice_note_off(msg->channel, msg->note);
+        break;
+    case MIDI_MSG_PITCH_BEND:
+        voice_set_pitch_bend(msg->bend);
+        break;
+    case MIDI_MSG_PROGRAM_CHANGE:
+        voice_select_patch(msg->note);
+        break;
+    case MIDI_MSG_CONTROL_CHANGE:
+        switch (msg->note)
+        {
+        case CC_MODULATION:
+            voice_set_modulation(msg->velocity);
+            break;
+        case CC_PORTAMENTO_TIME:
+            // Quadratic taper, 0..~4 s
+            portamento_ms = (uint16_t)(msg->velocity * msg->velocity / 4);
+            voice_set_portamento(portamento_ms, portamento_on);
+            break;
+        case CC_PORTAMENTO:
+            portamento_on = msg->velocity >= 64;
+            voice_set_portamento(portamento_ms, portamento_on);
+            break;
+        case CC_ALL_SOUND_OFF:
+        case CC_ALL_NOTES_OFF:
+            voice_all_off();
+            break;
+        default:
+            break;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void voice_set_pitch_bend(int16_t bend)
+{
+    // bend / 8192 * range semitones, in Q16
+    bend_pitch = (int32_t)bend * CONFIG_INTERRUPT_PITCH_BEND_RANGE * 8;
+}
+
+void voice_set_modulation(uint8_t value)
+{
+    modulation = value > MODULATION_MAX ? MODULATION_MAX : value;
+}
+
+void voice_set_portamento(uint16_t time_ms, bool enabled)
+{
+    glide_ticks = enabled ? (uint32_t)time_ms * control_rate / 1000 : 0;
+}
+
+void voice_set_lfo_period(uint32_t period_us)
+{
+    // LFO phase increment per control tick, 32 bits per turn. A single word
+    // store, so it can be retuned from another task while voices run.
+    if (period_us == 0)
+        lfo_sync_inc = 0;
+    else
+        lfo_sync_inc = (uint32_t)((1000000ULL << 32) /
+                                  ((uint64_t)period_us * control_rate));
+}
+
+// Uses the control rate, call after voice_init()
+void voice_patch_compile(voice_patch_t *out, const bank_preset_t *preset)
+{
+    const env_params_t env_params = {
+        .attack_ms = preset->attack_ms,
+        .decay_ms = preset->decay_ms,
+        .sustain = (preset->sustain > 100 ? 100 : preset->sustain) *
+                   ENV_LEVEL_MAX / 100,
+        .release_ms = preset->release_ms,
+        .shape = preset->env_shape == ENV_SHAPE_LINEAR ? ENV_SHAPE_LINEAR
+                                                       : ENV_SHAPE_EXPONENTIAL,
+    };
+    env_config(&out->env, &env_params, control_rate);
+
+    out->vel_curve = preset->vel_curve < VEL_CURVE_COUNT ? preset->vel_curve
+                                                          : VEL_CURVE_DEFAULT;
+    out->polyphony = preset->polyphony;
+    if (out->polyphony < 1) out->polyphony = 1;
+    if (out->polyphony > VOICE_COUNT) out->polyphony = VOICE_COUNT;
+    // Bank images are built off target, the coil limits are this build's
+    out->max_duty = preset->max_duty > CONFIG_INTERRUPT_MAX_DUTY
+                        ? CONFIG_INTERRUPT_MAX_DUTY
+                        : preset->max_duty;
+    uint16_t pd_max_us = preset->pd_max_us > CONFIG_INTERRUPT_PD_MAX
+                             ? CONFIG_INTERRUPT_PD_MAX
+                             : preset->pd_max_us;
+    out->pd_max = pd_max_us * (VOICE_TICK_HZ / 1000000);
+
+    out->vibrato_depth =
+        (int32_t)(((int64_t)preset->vibrato_cents << VOICE_PITCH_SHIFT) / 100);
+    uint8_t tremolo = preset->tremolo > 100 ? 100 : preset->tremolo;
+    out->tremolo_depth = tremolo * 32767 / 100;
+    out->lfo_inc = (uint32_t)(((uint64_t)preset->lfo_rate_dhz << 32) /
+                              (10ULL * control_rate));
+}
+
+void voice_set_patches(const voice_patch_t *table, uint8_t count)
+{
+    patch_count = 0;
+    patches = table;
+    patch_count = count;
+}
+
+bool voice_select_patch(uint8_t program)
+{
+    if (program >= patch_count) return false;
+    patch = &patches[program];
+    return true;
+}
+
+void voice_tick(void)
+{
+    const voice_patch_t *p = patch;
+
+    // Shared LFO, one table lookup per tick for all voices
+    lfo_phase += lfo_sync_inc ? lfo_sync_inc : p->lfo_inc;
+    int32_t lfo = sine_table[lfo_phase >> 24];
+    int32_t vibrato_depth = p->vibrato_depth * modulation / MODULATION_MAX;
+    int32_t tremolo_depth = p->tremolo_depth * modulation / MODULATION_MAX;
+    int32_t vibrato = (int32_t)(((int64_t)vibrato_depth * lfo) >> 15);
+    int32_t gain = 32767 - ((tremolo_depth * (32767 - lfo)) >> 16);
+
+    for (int i = 0; i < VOICE_COUNT; i++)
+    {
+        voice_t *v = &voices[i];
+        if (v->note == VOICE_NOTE_NONE) continue;
+
+        uint32_t level = env_step(&v->env, &p->env);
+        if (!env_is_active(&v->env))
+        {
+            voice_silence(v);
+            continue;
+        }
+
+        if (v->glide_ticks > 0)
+        {
+            v->pitch += v->glide_step;
+            if (--v->glide_ticks == 0) v->pitch = v->target_pitch;
+        }
+
+        uint32_t period =
+            voice_pitch_to_period(v->pitch + bend_pitch + vibrato);
+
+        uint32_t width = ((uint32_t)v->base_width * gain) >> 15;
+        width = (width * level) >> 15;
+        uint32_t max_width =
+            (period >> VOICE_PERIOD_SHIFT) * p->max_duty / 100;
+        counters.voice_ticks++;
+        if (width > max_width)
+        {
+            width = max_width;
+            counters.limited++;
+        }
+
+        // Picked up together by the scheduler at the next pulse boundary,
+        // the width always within the duty limit of its own period
+        voice_publish(v, period, (uint16_t)width);
+    }
+}
+
+uint8_t voice_active_count(void)
+{
+    uint8_t count = 0;
+    for (int i = 0; i < VOICE_COUNT; i++)
+    {
+        if (voices[i].period_q8 != 0) count++;
+    }
+    return count;
+}
+
+void voice_get_counters(voice_counters_t *out) { *out = counters; }
+
+uint32_t voice_pitch_to_period(int32_t pitch)
+{
+    if (pitch < 0) pitch = 0;
+    if (pitch > PITCH_MAX) pitch = PITCH_MAX;
+
+    // Bent above the table, at most two octaves
+    uint32_t note = (uint32_t)pitch >> VOICE_PITCH_SHIFT;
+    uint32_t shift = 0;
+    while (note >= TABLE_NOTE_COUNT)
+    {
+        note -= 12;
+        shift++;
+    }
+
+    uint32_t pos = (uint32_t)pitch & ((1 << VOICE_PITCH_SHIFT) - 1);
+    uint32_t idx = pos >> PITCH_FRAC_BITS;
+    uint32_t frac = pos & ((1 << PITCH_FRAC_BITS) - 1);
+
+    uint32_t a = pitch_frac_q30[idx];
+    uint32_t b = pitch_frac_q30[idx + 1];
+    uint32_t ratio =
+        a - (uint32_t)(((uint64_t)(a - b) * frac) >> PITCH_FRAC_BITS);
+
+    return (uint32_t)(((uint64_t)note_period_q8[note] * ratio +
+                       (1ULL << (29 + shift))) >>
+                      (30 + shift));
+}
+
+bool IRAM_ATTR voice_next_pulse(uint32_t now_q8, voice_pulse_t *pulse)
+{
+    voice_t *due = NULL;
+    int32_t due_in = INT32_MAX;
+
+    for (int i = 0; i < VOICE_COUNT; i++)
+    {
+        voice_t *v = &voices[i];
+        voice_read(v);
+        uint32_t period = v->pulse_period_q8;
+        if (period == 0 || v->pulse_width_tick == 0) continue;
+
+        int32_t in = (int32_t)(v->next_q8 - now_q8);
+        if (v->retrigger || in < -(int32_t)period)
+        {
+            // New note, or the voice fell behind: restart its phase now
+            v->retrigger = false;
+            v->next_q8 = now_q8;
+            in = 0;
+        }
+        else if (in > (int32_t)period)
+        {
+            // Period got shorter since the last pulse
+            v->next_q8 = now_q8 + period;
+            in = (int32_t)period;
+        }
+
+        if (in < due_in)
+        {
+            due_in = in;
+            due = v;
+        }
+    }
+
+    if (due == NULL) return false;
+
+    pulse->at_q8 = due->next_q8;
+    pulse->width_tick = due->pulse_width_tick;
+    due->next_q8 += due->pulse_period_q8;
+
+    return true;
+}
@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file voice.h
+ * @brief Polyphonic voice table and fixed-point modulation engine
+ *
+ * Voices are updated at the control rate by voice_tick() (pitch bend, LFO
+ * vibrato/tremolo, portamento, ADSR envelope) and publish a period and a
+ * pulse width that the pulse scheduler picks up at the next pulse boundary.
+ * A released voice keeps sounding until its envelope is over.
+ *
+ * Sound parameters (envelope, velocity curve, pulse width limits, vibrato,
+ * polyphony) come from a patch compiled from a bank_preset_t. Patches are
+ * compiled once at boot, program change then only swaps a pointer.
+ *
+ * Pitches are Q16 semitones (MIDI note << 16), periods are Q8 ticks of
+ * VOICE_TICK_HZ. No floating point is used once patches are compiled.
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+#ifndef VOICE_H
+#define VOICE_H
+
+// clang-format off
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "bank.h"
+#include "envelope.h"
+#include "midi.h"
+#include "sdkconfig.h"
+#include "tables.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef ESP_PLATFORM
+#include "esp_attr.h"
+#else
+#define IRAM_ATTR
+#endif
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define VOICE_COUNT CONFIG_INTERRUPT_VOICE_COUNT
+#define VOICE_TICK_HZ 1000000 // Pulse timer / RMT tick, 1 tick = 1 us
+
+#define VOICE_PITCH_SHIFT 16
+#define VOICE_PERIOD_SHIFT 8
+
+#define VOICE_NOTE_NONE 0xFF
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+typedef struct
+{
+    // Owned by the control task
+    uint8_t note;
+    uint8_t channel;
+    uint8_t velocity;
+    bool gate;
+    uint32_t age;
+    int32_t pitch;        // Current pitch, Q16 semitones
+    int32_t target_pitch; // Pitch the portamento converges to
+    int32_t glide_step;   // Pitch increment per control tick
+    uint32_t glide_ticks; // Control ticks left in the glide
+    uint16_t base_width;  // Pulse width before modulation, in ticks
+    envelope_t env;
+
+    // Published to the pulse scheduler as a pair, 0 period means silent.
+    // Odd sequence while the control task writes them.
+    volatile uint32_t seq;
+    volatile uint32_t period_q8;
+    volatile uint16_t width_tick;
+    volatile bool retrigger;
+
+    // Owned by the pulse scheduler, last pair read whole
+    uint32_t next_q8;
+    uint32_t pulse_period_q8;
+    uint16_t pulse_width_tick;
+} voice_t;
+
+typedef struct
+{
+    env_config_t env;
+    vel_curve_t vel_curve;
+    uint8_t polyphony;
+    uint8_t max_duty;      // % of the period
+    uint16_t pd_max;       // Width at full velocity, ticks
+    int32_t vibrato_depth; // Q16 semitones at full modulation
+    int32_t tremolo_depth; // Q15 at full modulation
+    uint32_t lfo_inc;      // Phase increment per control tick
+} voice_patch_t;
+
+// Free running, written by the control task only
+typedef struct
+{
+    uint32_t voice_ticks; // Active voices summed over the control ticks
+    uint32_t limited;     // Of which the duty limit clamped the width
+} voice_counters_t;
+
+typedef struct
+{
+    uint32_t at_q8;      // Pulse start, Q8 ticks
+    uint16_t width_tick; // Pulse width, ticks
+} voice_pulse_t;
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+void voice_init(uint32_t control_rate_hz);
+
+void voice_note_on(uint8_t channel, uint8_t note, uint8_t velocity);
+void voice_note_off(uint8_t channel, uint8_t note);
+void voice_all_off(void);
+void voice_handle_message(const midi_message_t *msg);
+
+void voice_set_pitch_bend(int16_t bend);
+void voice_set_modulation(uint8_t value);
+void voice_set_portamento(uint16_t time_ms, bool enabled);
+void voice_set_lfo_period(uint32_t period_us); // 0: patch rate
+
+void voice_patch_compile(voice_patch_t *out, const bank_preset_t *preset);
+void voice_set_patches(const voice_patch_t *patches, uint8_t count);
+bool voice_select_patch(uint8_t program);
+
+void voice_tick(void);
+uint8_t voice_active_count(void);
+void voice_get_counters(voice_counters_t *counters);
+
+uint32_t voice_pitch_to_period(int32_t pitch);
+bool voice_next_pulse(uint32_t now_q8, voice_pulse_t *pulse);
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
+
+#endif /* !VOICE_H */
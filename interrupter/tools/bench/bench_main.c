@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file bench_main.c
+ * @brief Run the firmware microbenchmarks on the host
+ *
+ * Prints one JSON line per case on stdout, tagged with the git revision
+ * the tools were configured from. Append the output of each commit to a
+ * file to follow regressions:
+ *
+ *   bench >> bench.jsonl
+ *
+ * Usage:
+ *   bench [name]
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "bench.h"
+#include <stdio.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#ifndef BENCH_REVISION
+#define BENCH_REVISION "unknown"
+#endif
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static void print_result(const bench_result_t *result, void *ctx)
+{
+    (void)ctx;
+    char line[256];
+    bench_format(result, BENCH_REVISION, line, sizeof(line));
+    puts(line);
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    if (argc > 2)
+    {
+        fprintf(stderr, "usage: bench [name]\n");
+        return 2;
+    }
+
+    if (bench_run(argc == 2 ? argv[1] : NULL, print_result, NULL) == 0)
+    {
+        fprintf(stderr, "bench: no case matches '%s'\n", argv[1]);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,153 @@
+#!/usr/bin/env python3
+#
+# Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+#
+# Distributed under terms of the MIT license.
+#
+"""Generate the note/velocity lookup tables from the project sdkconfig.
+
+Usage: gen_tables.py <sdkconfig> <output header>
+
+Run by the main component build whenever sdkconfig changes. The generated
+tables are checked against exact double precision values before the header
+is written, the build fails if they drift out of tolerance.
+"""
+
+import math
+import sys
+
+TICK_HZ = 1000000  # Pulse timer / RMT tick, see voice.h
+PERIOD_SHIFT = 8  # Periods are Q8 ticks
+FRAC_STEPS = 16  # Fine pitch table entries per semitone
+FRAC_BITS = 12  # Q16 semitone fraction >> FRAC_BITS = fine table index
+ONE_Q30 = 1 << 30
+ONE_Q15 = 32767
+
+# Tolerances of the accuracy check
+PERIOD_MAX_ERR_LSB = 0.5
+PITCH_MAX_ERR_LSB = 1.0  # Rounding of the note table and of the Q8 result
+PITCH_MAX_REL_ERR = 5e-6  # Linear interpolation of the fine table
+
+
+def read_sdkconfig(path):
+    config = {}
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if not line.startswith("CONFIG_") or "=" not in line:
+                continue
+            key, value = line.split("=", 1)
+            config[key[len("CONFIG_"):]] = value
+    return config
+
+
+def note_freq(note):
+    return 440.0 * 2.0 ** ((note - 69) / 12.0)
+
+
+def note_periods():
+    return [round(TICK_HZ / note_freq(n) * (1 << PERIOD_SHIFT)) for n in range(128)]
+
+
+def pitch_frac():
+    # 2^(-i / (12 * 16)), one semitone plus the interpolation guard entry
+    return [round(ONE_Q30 * 2.0 ** (-i / (12.0 * FRAC_STEPS))) for i in range(FRAC_STEPS + 1)]
+
+
+def velocity_curves(gamma):
+    curves = {
+        "LINEAR": lambda x: x,
+        "LOG": lambda x: math.log10(1.0 + 9.0 * x),
+        "CUSTOM": lambda x: x ** gamma,
+    }
+    return {name: [0] + [max(1, round(ONE_Q15 * f(v / 127.0))) for v in range(1, 128)]
+            for name, f in curves.items()}
+
+
+def ontime_comp(exponent, ref_note):
+    ref = note_freq(ref_note)
+    return [min(ONE_Q15, round(ONE_Q15 * (ref / note_freq(n)) ** exponent)) for n in range(128)]
+
+
+def period_from_tables(periods, frac, pitch_q16):
+    # Same arithmetic as voice_pitch_to_period()
+    note = pitch_q16 >> 16
+    shift = 0
+    while note > 127:
+        note -= 12
+        shift += 1
+    pos = pitch_q16 & 0xFFFF
+    idx = pos >> FRAC_BITS
+    sub = pos & ((1 << FRAC_BITS) - 1)
+    a, b = frac[idx], frac[idx + 1]
+    ratio = a - (((a - b) * sub) >> FRAC_BITS)
+    return (periods[note] * ratio + (1 << (29 + shift))) >> (30 + shift)
+
+
+def check(periods, frac, curves):
+    errors = []
+
+    for n, p in enumerate(periods):
+        exact = TICK_HZ / note_freq(n) * (1 << PERIOD_SHIFT)
+        if abs(p - exact) > PERIOD_MAX_ERR_LSB:
+            errors.append("note %d period off by %.3f LSB" % (n, p - exact))
+
+    worst = 0.0
+    for pitch in range(0, (127 + 24) << 16, 997):
+        exact = TICK_HZ / note_freq(pitch / 65536.0) * (1 << PERIOD_SHIFT)
+        err = abs(period_from_tables(periods, frac, pitch) - exact)
+        worst = max(worst, err / (PITCH_MAX_ERR_LSB + PITCH_MAX_REL_ERR * exact))
+    if worst > 1.0:
+        errors.append("fine pitch error %.2fx over tolerance" % worst)
+
+    for name, curve in curves.items():
+        if curve[127] != ONE_Q15 or any(b < a for a, b in zip(curve, curve[1:])):
+            errors.append("velocity curve %s is not monotonic to full scale" % name)
+
+    return errors
+
+
+def c_array(ctype, name, values, per_line=8, dims=""):
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append("    " + ", ".join(str(v) for v in values[i:i + per_line]) + ",")
+    return "const %s %s%s[%d] = {\n%s\n};\n" % (ctype, name, dims, len(values), "\n".join(lines))
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit(__doc__)
+
+    config = read_sdkconfig(sys.argv[1])
+    gamma = int(config.get("INTERRUPT_VELOCITY_GAMMA", "200")) / 100.0
+    comp = int(config.get("INTERRUPT_ONTIME_COMP", "50")) / 100.0
+    ref_note = int(config.get("INTERRUPT_ONTIME_REF_NOTE", "60"))
+
+    periods = note_periods()
+    frac = pitch_frac()
+    curves = velocity_curves(gamma)
+    widths = ontime_comp(comp, ref_note)
+
+    errors = check(periods, frac, curves)
+    if errors:
+        sys.exit("gen_tables.py: " + "; ".join(errors))
+
+    out = []
+    out.append("/* Generated by tools/gen_tables.py from sdkconfig, do not edit */\n")
+    out.append("#include <stdint.h>\n")
+    out.append(c_array("uint32_t", "note_period_q8", periods))
+    out.append(c_array("uint32_t", "pitch_frac_q30", frac, per_line=4))
+    rows = []
+    for name in ("LINEAR", "LOG", "CUSTOM"):
+        rows.append("    [VEL_CURVE_%s] = {\n" % name + "\n".join(
+            "        " + ", ".join(str(v) for v in curves[name][i:i + 8]) + ","
+            for i in range(0, 128, 8)) + "\n    },")
+    out.append("const uint16_t velocity_q15[VEL_CURVE_COUNT][128] = {\n%s\n};\n" % "\n".join(rows))
+    out.append(c_array("uint16_t", "note_width_q15", widths))
+
+    with open(sys.argv[2], "w") as f:
+        f.write("\n".join(out))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,293 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file mkbank.c
+ * @brief Build a voice preset bank image from a text description
+ *
+ * Each [name] section is a preset, in program order. Presets start from
+ * the Kconfig defaults, keys override them:
+ *
+ *   [Lead]
+ *   attack_ms = 2
+ *   decay_ms = 300
+ *   sustain = 70        ; %
+ *   release_ms = 150
+ *   shape = exponential ; or linear
+ *   curve = log         ; linear, log or custom
+ *   polyphony = 4
+ *   pd_max_us = 80
+ *   max_duty = 10       ; %
+ *   vibrato_cents = 50
+ *   tremolo = 0         ; %
+ *   lfo_rate_dhz = 55
+ *
+ * pd_max_us and max_duty are limited to CONFIG_INTERRUPT_PD_MAX and
+ * CONFIG_INTERRUPT_MAX_DUTY, the firmware clamps them again on load.
+ *
+ * The image is opened back with the firmware reader before it is written.
+ *
+ * Usage:
+ *   mkbank <in.ini> <out.pbk>
+ *   mkbank --dump <in.pbk>
+ *
+ * Flash the image with:
+ *   parttool.py write_partition --partition-name patches --input out.pbk
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "bank.h"
+#include "envelope.h"
+#include "sdkconfig.h"
+#include "tables.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define LINE_MAX_LEN 256
+
+#define FIELD(name, max) \
+    {#name, offsetof(bank_preset_t, name), \
+     sizeof(((bank_preset_t *)0)->name), max}
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+typedef struct
+{
+    const char *key;
+    size_t offset;
+    size_t size;
+    long max;
+} field_t;
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static const field_t fields[] = {
+    FIELD(attack_ms, 65535),
+    FIELD(decay_ms, 65535),
+    FIELD(release_ms, 65535),
+    FIELD(sustain, 100),
+    FIELD(polyphony, 255),
+    FIELD(pd_max_us, CONFIG_INTERRUPT_PD_MAX),
+    FIELD(max_duty, CONFIG_INTERRUPT_MAX_DUTY),
+    FIELD(vibrato_cents, 1200),
+    FIELD(tremolo, 100),
+    FIELD(lfo_rate_dhz, 2000),
+};
+
+static const char *shapes[] = {"linear", "exponential"};
+static const char *curves[] = {"linear", "log", "custom"};
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static char *trim(char *s)
+{
+    while (isspace((unsigned char)*s)) s++;
+    char *end = s + strlen(s);
+    while (end > s && isspace((unsigned char)end[-1])) end--;
+    *end = '\0';
+    return s;
+}
+
+static int lookup(const char *value, const char **names, int count)
+{
+    for (int i = 0; i < count; i++)
+        if (strcmp(value, names[i]) == 0) return i;
+    return -1;
+}
+
+static int set_key(bank_preset_t *preset, const char *key, const char *value)
+{
+    if (strcmp(key, "shape") == 0)
+    {
+        int shape = lookup(value, shapes, 2);
+        if (shape < 0) return -1;
+        preset->env_shape = shape == 0 ? ENV_SHAPE_LINEAR
+                                       : ENV_SHAPE_EXPONENTIAL;
+        return 0;
+    }
+
+    if (strcmp(key, "curve") == 0)
+    {
+        int curve = lookup(value, curves, VEL_CURVE_COUNT);
+        if (curve < 0) return -1;
+        preset->vel_curve = curve;
+        return 0;
+    }
+
+    for (size_t i = 0; i < sizeof(fields) / sizeof(fields[0]); i++)
+    {
+        if (strcmp(key, fields[i].key) != 0) continue;
+
+        char *end;
+        long v = strtol(value, &end, 0);
+        if (*end != '\0' || v < 0 || v > fields[i].max) return -1;
+
+        uint8_t *dst = (uint8_t *)preset + fields[i].offset;
+        if (fields[i].size == 1)
+            *dst = (uint8_t)v;
+        else
+            *(uint16_t *)dst = (uint16_t)v;
+        return 0;
+    }
+
+    return -1;
+}
+
+static int parse(const char *path, bank_preset_t *presets, int *count)
+{
+    FILE *f = fopen(path, "r");
+    if (f == NULL)
+    {
+        perror(path);
+        return -1;
+    }
+
+    char buf[LINE_MAX_LEN];
+    int line = 0;
+    *count = 0;
+
+    while (fgets(buf, sizeof(buf), f))
+    {
+        line++;
+        char *comment = strpbrk(buf, ";#");
+        if (comment) *comment = '\0';
+        char *s = trim(buf);
+        if (*s == '\0') continue;
+
+        if (*s == '[')
+        {
+            char *close = strchr(s, ']');
+            if (close == NULL || *count == BANK_MAX_PRESETS) goto error;
+            *close = '\0';
+
+            bank_preset_t *preset = &presets[(*count)++];
+            bank_preset_default(preset);
+            memset(preset->name, 0, BANK_NAME_LEN);
+            strncpy(preset->name, trim(s + 1), BANK_NAME_LEN);
+            continue;
+        }
+
+        char *eq = strchr(s, '=');
+        if (eq == NULL || *count == 0) goto error;
+        *eq = '\0';
+        if (set_key(&presets[*count - 1], trim(s), trim(eq + 1)) < 0)
+            goto error;
+    }
+
+    fclose(f);
+    if (*count == 0)
+    {
+        fprintf(stderr, "mkbank: %s: no preset\n", path);
+        return -1;
+    }
+    return 0;
+
+error:
+    fprintf(stderr, "mkbank: %s:%d: invalid line\n", path, line);
+    fclose(f);
+    return -1;
+}
+
+static void print_preset(int program, const bank_preset_t *p)
+{
+    printf("%3d %-12.12s A%u D%u S%u%% R%u %s %s poly %u pd %u us duty %u%% "
+           "vib %u c trem %u%% lfo %u.%u Hz\n",
+           program, p->name, p->attack_ms, p->decay_ms, p->sustain,
+           p->release_ms, shapes[p->env_shape == ENV_SHAPE_EXPONENTIAL],
+           p->vel_curve < VEL_CURVE_COUNT ? curves[p->vel_curve] : "?",
+           p->polyphony, p->pd_max_us, p->max_duty, p->vibrato_cents,
+           p->tremolo, p->lfo_rate_dhz / 10, p->lfo_rate_dhz % 10);
+}
+
+static int dump(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    static uint8_t data[sizeof(bank_header_t) +
+                        BANK_MAX_PRESETS * sizeof(bank_preset_t)];
+    if (f == NULL)
+    {
+        perror(path);
+        return 1;
+    }
+    size_t size = fread(data, 1, sizeof(data), f);
+    fclose(f);
+
+    uint16_t count;
+    const bank_preset_t *presets = bank_open(data, size, &count);
+    if (presets == NULL)
+    {
+        fprintf(stderr, "mkbank: %s: not a preset bank\n", path);
+        return 1;
+    }
+
+    for (int i = 0; i < count; i++) print_preset(i, &presets[i]);
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    if (argc == 3 && strcmp(argv[1], "--dump") == 0) return dump(argv[2]);
+
+    if (argc != 3)
+    {
+        fprintf(stderr, "usage: mkbank <in.ini> <out.pbk>\n"
+                        "       mkbank --dump <in.pbk>\n");
+        return 2;
+    }
+
+    static struct
+    {
+        bank_header_t hdr;
+        bank_preset_t presets[BANK_MAX_PRESETS];
+    } image;
+    int count;
+    if (parse(argv[1], image.presets, &count) < 0) return 1;
+
+    image.hdr = (bank_header_t){
+        .magic = BANK_MAGIC,
+        .version = BANK_VERSION,
+        .preset_count = count,
+        .preset_size = sizeof(bank_preset_t),
+    };
+    size_t size = sizeof(image.hdr) + count * sizeof(bank_preset_t);
+
+    uint16_t check;
+    if (bank_open((const uint8_t *)&image, size, &check) == NULL ||
+        check != count)
+    {
+        fprintf(stderr, "mkbank: image does not read back\n");
+        return 1;
+    }
+
+    FILE *f = fopen(argv[2], "wb");
+    if (f == NULL || fwrite(&image, 1, size, f) != size)
+    {
+        perror(argv[2]);
+        return 1;
+    }
+    fclose(f);
+
+    for (int i = 0; i < count; i++) print_preset(i, &image.presets[i]);
+    printf("%d presets, %zu bytes\n", count, size);
+    return 0;
+}
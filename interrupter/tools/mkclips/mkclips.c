@@ -0,0 +1,293 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file mkclips.c
+ * @brief Build a PCM clip bank image from WAV files
+ *
+ * Each WAV file (PCM, 8 or 16 bits, mono or stereo) becomes a clip, in
+ * argument order: clip 0 is played by CONFIG_INTERRUPT_CLIP_BASE_NOTE, the
+ * next one by the note above. Clips are mixed down to mono, resampled
+ * linearly to the bank rate and stored as signed 8 bits.
+ *
+ * The image is opened back with the firmware reader before it is written.
+ *
+ * Usage:
+ *   mkclips [-r rate] <out.clp> <in.wav>...
+ *   mkclips --dump <in.clp>
+ *
+ * Flash the image with:
+ *   parttool.py write_partition --partition-name clips --input out.clp
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "clip.h"
+#include "sdkconfig.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define DEFAULT_RATE 16000
+#define MAX_CLIPS 128
+#define MAX_IMAGE (1 << 24)
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+typedef struct
+{
+    int16_t *samples; // Mono, 16 bits
+    uint32_t length;
+    uint32_t rate;
+} wav_t;
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static clip_entry_t index_table[MAX_CLIPS];
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static uint32_t le32(const uint8_t *p)
+{
+    return p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static uint16_t le16(const uint8_t *p) { return p[0] | p[1] << 8; }
+
+static uint8_t *read_file(const char *path, size_t *size)
+{
+    FILE *f = fopen(path, "rb");
+    if (f == NULL)
+    {
+        perror(path);
+        return NULL;
+    }
+
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    uint8_t *data = malloc(len > 0 ? len : 1);
+    if (data == NULL || fread(data, 1, len, f) != (size_t)len)
+    {
+        perror(path);
+        free(data);
+        fclose(f);
+        return NULL;
+    }
+    fclose(f);
+
+    *size = len;
+    return data;
+}
+
+static int read_wav(const char *path, wav_t *wav)
+{
+    size_t size;
+    uint8_t *data = read_file(path, &size);
+    if (data == NULL) return -1;
+
+    uint16_t format = 0, channels = 0, bits = 0;
+    const uint8_t *pcm = NULL;
+    uint32_t pcm_size = 0;
+
+    if (size < 12 || memcmp(data, "RIFF", 4) || memcmp(data + 8, "WAVE", 4))
+        goto error;
+
+    for (size_t pos = 12; pos + 8 <= size;)
+    {
+        uint32_t chunk = le32(data + pos + 4);
+        if (chunk > size - pos - 8) chunk = size - pos - 8;
+
+        if (memcmp(data + pos, "fmt ", 4) == 0 && chunk >= 16)
+        {
+            format = le16(data + pos + 8);
+            channels = le16(data + pos + 10);
+            wav->rate = le32(data + pos + 12);
+            bits = le16(data + pos + 22);
+        }
+        else if (memcmp(data + pos, "data", 4) == 0)
+        {
+            pcm = data + pos + 8;
+            pcm_size = chunk;
+        }
+        pos += 8 + chunk + (chunk & 1);
+    }
+
+    if (format != 1 || channels < 1 || channels > 2 ||
+        (bits != 8 && bits != 16) || pcm == NULL || wav->rate == 0)
+        goto error;
+
+    uint32_t frame = channels * bits / 8;
+    wav->length = pcm_size / frame;
+    wav->samples = malloc((wav->length ? wav->length : 1) * sizeof(int16_t));
+
+    for (uint32_t i = 0; i < wav->length; i++)
+    {
+        int32_t sum = 0;
+        for (int c = 0; c < channels; c++)
+        {
+            const uint8_t *p = pcm + i * frame + c * bits / 8;
+            sum += bits == 8 ? (p[0] - 128) << 8 : (int16_t)le16(p);
+        }
+        wav->samples[i] = sum / channels;
+    }
+
+    free(data);
+    return 0;
+
+error:
+    fprintf(stderr, "mkclips: %s: not a PCM 8/16 bit WAV file\n", path);
+    free(data);
+    return -1;
+}
+
+// Linear interpolation to the bank rate, rounded to signed 8 bits
+static uint32_t resample(const wav_t *wav, uint32_t rate, int8_t *out,
+                         uint32_t room)
+{
+    uint64_t length = (uint64_t)wav->length * rate / wav->rate;
+    if (length > room) length = room;
+
+    for (uint32_t i = 0; i < length; i++)
+    {
+        uint64_t pos_q16 = ((uint64_t)i * wav->rate << 16) / rate;
+        uint32_t at = pos_q16 >> 16;
+        int32_t frac = pos_q16 & 0xFFFF;
+        int32_t a = wav->samples[at];
+        int32_t b = at + 1 < wav->length ? wav->samples[at + 1] : a;
+        int32_t s = a + (((b - a) * frac) >> 16);
+
+        s = (s + 128) >> 8;
+        if (s > 127) s = 127;
+        if (s < -128) s = -128;
+        out[i] = (int8_t)s;
+    }
+
+    return (uint32_t)length;
+}
+
+static void print_clip(int index, uint32_t length, uint32_t rate)
+{
+    printf("%3d note %3d %7u samples %5u ms\n", index,
+           CONFIG_INTERRUPT_CLIP_BASE_NOTE + index, length,
+           (uint32_t)((uint64_t)length * 1000 / rate));
+}
+
+static int dump(const char *path)
+{
+    size_t size;
+    uint8_t *data = read_file(path, &size);
+    if (data == NULL) return 1;
+
+    const clip_header_t *hdr = clip_open(data, size);
+    if (hdr == NULL)
+    {
+        fprintf(stderr, "mkclips: %s: not a clip bank\n", path);
+        free(data);
+        return 1;
+    }
+
+    for (int i = 0; i < hdr->clip_count; i++)
+    {
+        const int8_t *samples;
+        uint32_t length;
+        clip_get(hdr, i, &samples, &length);
+        print_clip(i, length, hdr->sample_rate);
+    }
+    printf("%u clips at %u Hz, %zu bytes\n", hdr->clip_count, hdr->sample_rate,
+           size);
+
+    free(data);
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    if (argc == 3 && strcmp(argv[1], "--dump") == 0) return dump(argv[2]);
+
+    uint32_t rate = DEFAULT_RATE;
+    int arg = 1;
+    if (argc > 2 && strcmp(argv[1], "-r") == 0)
+    {
+        rate = strtoul(argv[2], NULL, 0);
+        arg = 3;
+    }
+
+    int count = argc - arg - 1;
+    if (count < 1 || count > MAX_CLIPS || rate < 1000 || rate > 48000)
+    {
+        fprintf(stderr, "usage: mkclips [-r rate] <out.clp> <in.wav>...\n"
+                        "       mkclips --dump <in.clp>\n");
+        return 2;
+    }
+
+    size_t data_offset =
+        sizeof(clip_header_t) + count * sizeof(clip_entry_t);
+    uint8_t *image = calloc(1, MAX_IMAGE);
+    uint32_t data_size = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        wav_t wav;
+        if (read_wav(argv[arg + 1 + i], &wav) < 0) return 1;
+
+        int8_t *out = (int8_t *)image + data_offset + data_size;
+        uint32_t room = MAX_IMAGE - data_offset - data_size;
+        index_table[i].offset = data_size;
+        index_table[i].length = resample(&wav, rate, out, room);
+        data_size += index_table[i].length;
+        free(wav.samples);
+    }
+
+    clip_header_t hdr = {
+        .magic = CLIP_MAGIC,
+        .version = CLIP_VERSION,
+        .clip_count = count,
+        .sample_rate = rate,
+        .index_offset = sizeof(clip_header_t),
+        .data_offset = data_offset,
+        .data_size = data_size,
+    };
+    memcpy(image, &hdr, sizeof(hdr));
+    memcpy(image + hdr.index_offset, index_table,
+           count * sizeof(clip_entry_t));
+    size_t size = data_offset + data_size;
+
+    if (clip_open(image, size) == NULL)
+    {
+        fprintf(stderr, "mkclips: image does not read back\n");
+        return 1;
+    }
+
+    FILE *f = fopen(argv[arg], "wb");
+    if (f == NULL || fwrite(image, 1, size, f) != size)
+    {
+        perror(argv[arg]);
+        return 1;
+    }
+    fclose(f);
+
+    for (int i = 0; i < count; i++)
+        print_clip(i, index_table[i].length, rate);
+    printf("%d clips at %u Hz, %zu bytes\n", count, rate, size);
+    free(image);
+    return 0;
+}
@@ -0,0 +1,364 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file pulsetl.c
+ * @brief Render a MIDI file into a precompiled pulse timeline
+ *
+ * The arrangement is played through the firmware voice engine (same
+ * tables, envelopes and scheduler), with the pulse timer of pwm.c driven
+ * in virtual time. The image is decoded back and compared with
+ * the rendered pulses before the tool exits.
+ *
+ * Usage:
+ *   pulsetl <in.mid> <out.ptl> [block records]
+ *   pulsetl --dump <in.ptl>
+ *
+ * Flash the image with:
+ *   parttool.py write_partition --partition-name show --input out.ptl
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "pulse.h"
+#include "sdkconfig.h"
+#include "smf.h"
+#include "timeline.h"
+#include "voice.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define CONTROL_RATE_HZ CONFIG_INTERRUPT_CONTROL_RATE_HZ
+
+// Stop rendering if voices never go idle
+#define TAIL_MAX_US (10 * 1000000ULL)
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+typedef struct
+{
+    tl_pulse_t *items;
+    size_t count;
+    size_t cap;
+} pulse_list_t;
+
+typedef struct
+{
+    uint8_t *data;
+    size_t size;
+    size_t cap;
+} buffer_t;
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static void *xrealloc(void *ptr, size_t size)
+{
+    void *p = realloc(ptr, size);
+    if (p == NULL)
+    {
+        fprintf(stderr, "pulsetl: out of memory\n");
+        exit(1);
+    }
+    return p;
+}
+
+static uint8_t *read_file(const char *path, size_t *size)
+{
+    FILE *f = fopen(path, "rb");
+    if (f == NULL)
+    {
+        perror(path);
+        exit(1);
+    }
+
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    uint8_t *data = xrealloc(NULL, len > 0 ? len : 1);
+    if (fread(data, 1, len, f) != (size_t)len)
+    {
+        perror(path);
+        exit(1);
+    }
+    fclose(f);
+
+    *size = len;
+    return data;
+}
+
+static void pulse_list_push(pulse_list_t *list, tl_pulse_t pulse)
+{
+    if (list->count == list->cap)
+    {
+        list->cap = list->cap ? list->cap * 2 : 1024;
+        list->items = xrealloc(list->items, list->cap * sizeof(tl_pulse_t));
+    }
+    list->items[list->count++] = pulse;
+}
+
+static void buffer_put(buffer_t *buf, const void *data, size_t len)
+{
+    if (buf->size + len > buf->cap)
+    {
+        buf->cap = (buf->size + len) * 2;
+        buf->data = xrealloc(buf->data, buf->cap);
+    }
+    memcpy(buf->data + buf->size, data, len);
+    buf->size += len;
+}
+
+static void buffer_put_varint(buffer_t *buf, uint32_t value)
+{
+    do
+    {
+        uint8_t b = value & 0x7F;
+        value >>= 7;
+        if (value) b |= 0x80;
+        buffer_put(buf, &b, 1);
+    } while (value);
+}
+
+// Play the file through the voice engine, in virtual time
+static void render(smf_t *smf, pulse_list_t *out)
+{
+    const uint64_t ctrl_period = VOICE_TICK_HZ / CONTROL_RATE_HZ;
+
+    uint64_t t_ctrl = 0;
+    uint64_t t_alarm = PULSE_IDLE_POLL;
+    uint64_t t_last_event = 0;
+    pulse_sched_t sched;
+    pulse_sched_reset(&sched);
+
+    smf_event_t ev;
+    bool has_event = smf_next(smf, &ev);
+
+    voice_init(CONTROL_RATE_HZ);
+
+    while (1)
+    {
+        if (t_ctrl <= t_alarm)
+        {
+            // Control timer: drain the messages due, then modulate
+            while (has_event && ev.time_us <= t_ctrl)
+            {
+                voice_handle_message(&ev.msg);
+                t_last_event = ev.time_us;
+                has_event = smf_next(smf, &ev);
+            }
+            voice_tick();
+            t_ctrl += ctrl_period;
+
+            // Held notes always have a pulse pending, the tail limit
+            // does not wait for one
+            if (!has_event && ((voice_active_count() == 0 &&
+                                sched.pending.width_tick == 0) ||
+                               t_ctrl > t_last_event + TAIL_MAX_US))
+                break;
+            continue;
+        }
+
+        // Pulse timer ISR
+        uint64_t now = t_alarm;
+        uint32_t in;
+        uint16_t width =
+            pulse_sched_alarm(&sched, (uint32_t)now, voice_next_pulse, &in);
+        if (width > 0)
+        {
+            tl_pulse_t pulse = {.time_us = (uint32_t)now, .width_tick = width};
+            pulse_list_push(out, pulse);
+        }
+        t_alarm = now + in;
+    }
+}
+
+static void encode(const pulse_list_t *pulses, uint32_t block_records,
+                   buffer_t *out)
+{
+    uint32_t block_count =
+        (uint32_t)((pulses->count + block_records - 1) / block_records);
+
+    tl_header_t hdr = {
+        .magic = TL_MAGIC,
+        .version = TL_VERSION,
+        .output_count = 1,
+        .tick_hz = VOICE_TICK_HZ,
+        .record_count = (uint32_t)pulses->count,
+        .block_count = block_count,
+        .block_records = block_records,
+        .index_offset = sizeof(tl_header_t),
+        .data_offset = sizeof(tl_header_t) + block_count * sizeof(tl_block_t),
+    };
+
+    tl_block_t *index = xrealloc(NULL, (block_count + 1) * sizeof(tl_block_t));
+    buffer_t data = {0};
+    uint32_t time = 0;
+
+    for (size_t i = 0; i < pulses->count; i++)
+    {
+        const tl_pulse_t *p = &pulses->items[i];
+        if (i % block_records == 0)
+        {
+            index[i / block_records].time_us = p->time_us;
+            index[i / block_records].offset = (uint32_t)data.size;
+            time = p->time_us;
+        }
+        buffer_put_varint(&data, ((p->time_us - time) << TL_OUTPUT_BITS) |
+                                     (p->output & (TL_MAX_OUTPUTS - 1)));
+        buffer_put_varint(&data, p->width_tick);
+        time = p->time_us;
+    }
+
+    if (pulses->count > 0)
+    {
+        const tl_pulse_t *last = &pulses->items[pulses->count - 1];
+        hdr.duration_us = last->time_us + last->width_tick;
+    }
+    hdr.data_size = (uint32_t)data.size;
+
+    buffer_put(out, &hdr, sizeof(hdr));
+    buffer_put(out, index, block_count * sizeof(tl_block_t));
+    buffer_put(out, data.data, data.size);
+
+    free(index);
+    free(data.data);
+}
+
+// Decode the image back, sequentially and through the block index
+static int verify(const pulse_list_t *pulses, const buffer_t *image)
+{
+    tl_reader_t r;
+    tl_pulse_t p;
+
+    if (!tl_open(&r, image->data, image->size))
+    {
+        fprintf(stderr, "pulsetl: verify: image rejected by decoder\n");
+        return 1;
+    }
+
+    for (size_t i = 0; i < pulses->count; i++)
+    {
+        const tl_pulse_t *e = &pulses->items[i];
+        if (!tl_next(&r, &p) || p.time_us != e->time_us ||
+            p.width_tick != e->width_tick || p.output != e->output)
+        {
+            fprintf(stderr, "pulsetl: verify: record %zu differs\n", i);
+            return 1;
+        }
+    }
+    if (tl_next(&r, &p))
+    {
+        fprintf(stderr, "pulsetl: verify: trailing records\n");
+        return 1;
+    }
+
+    // Seek to every block start and in between two records
+    for (size_t i = 0; i < pulses->count; i += r.hdr->block_records / 2 + 1)
+    {
+        uint32_t t = pulses->items[i].time_us;
+        size_t first = i;
+        while (first > 0 && pulses->items[first - 1].time_us >= t) first--;
+
+        if (!tl_seek(&r, t) || !tl_next(&r, &p) ||
+            p.time_us != pulses->items[first].time_us)
+        {
+            fprintf(stderr, "pulsetl: verify: seek to %u us failed\n", t);
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static int dump(const char *path)
+{
+    size_t size;
+    uint8_t *data = read_file(path, &size);
+    tl_reader_t r;
+    tl_pulse_t p;
+
+    if (!tl_open(&r, data, size))
+    {
+        fprintf(stderr, "pulsetl: %s: not a pulse timeline\n", path);
+        return 1;
+    }
+
+    printf("# %u pulses, %u blocks of %u, %u us\n", r.hdr->record_count,
+           r.hdr->block_count, r.hdr->block_records, r.hdr->duration_us);
+    printf("# time_us width_tick output\n");
+    while (tl_next(&r, &p))
+        printf("%u %u %u\n", p.time_us, p.width_tick, p.output);
+
+    free(data);
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    if (argc == 3 && strcmp(argv[1], "--dump") == 0) return dump(argv[2]);
+
+    if (argc != 3 && argc != 4)
+    {
+        fprintf(stderr, "usage: pulsetl <in.mid> <out.ptl> [block records]\n"
+                        "       pulsetl --dump <in.ptl>\n");
+        return 2;
+    }
+
+    uint32_t block_records = argc == 4 ? (uint32_t)atoi(argv[3])
+                                       : TL_BLOCK_RECORDS;
+    if (block_records == 0)
+    {
+        fprintf(stderr, "pulsetl: invalid block size\n");
+        return 2;
+    }
+
+    size_t size;
+    uint8_t *mid = read_file(argv[1], &size);
+    static smf_t smf;
+    if (smf_open(&smf, mid, size) == 0)
+    {
+        fprintf(stderr, "pulsetl: %s: not a format 0/1 MIDI file\n", argv[1]);
+        return 1;
+    }
+
+    pulse_list_t pulses = {0};
+    render(&smf, &pulses);
+
+    buffer_t image = {0};
+    encode(&pulses, block_records, &image);
+    if (verify(&pulses, &image)) return 1;
+
+    FILE *f = fopen(argv[2], "wb");
+    if (f == NULL || fwrite(image.data, 1, image.size, f) != image.size)
+    {
+        perror(argv[2]);
+        return 1;
+    }
+    fclose(f);
+
+    printf("%zu pulses, %.1f s, %zu bytes (%.2f bytes/pulse)\n", pulses.count,
+           pulses.count ? pulses.items[pulses.count - 1].time_us / 1e6 : 0.0,
+           image.size, pulses.count ? (double)image.size / pulses.count : 0.0);
+
+    free(mid);
+    free(pulses.items);
+    free(image.data);
+    return 0;
+}
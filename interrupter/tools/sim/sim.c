@@ -0,0 +1,497 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file sim.c
+ * @brief Render the firmware output pin offline, as VCD and WAV
+ *
+ * A MIDI file is played in MIDI mode: messages go through the firmware
+ * parser and voice engine, and the pulse timer of pwm.c is driven in
+ * virtual time by the same scheduler (pulse.c). A WAV file is played in
+ * audio mode: it is sampled like the jack ADC, mapped to a duty by the
+ * audio output stage and turned into the 8 bit, 30 kHz LEDC waveform.
+ * Both go through the output layer to the mock backend, armed.
+ *
+ * The output pin can be written as a VCD trace (exact edges, 1 ns scale)
+ * and as a WAV approximation of what the arc sounds like: the on-time per
+ * sample, DC removed. The summary line carries a hash of the pulse train
+ * to compare two firmware versions without diffing the traces.
+ *
+ * -b times the output calls through the backend table against direct
+ * calls of the mock, the cost of the dispatch on the host.
+ *
+ * Usage:
+ *   sim [-v out.vcd] [-w out.wav] [-t seconds] <in.mid | in.wav>
+ *   sim -b <calls>
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "output.h"
+#include "output_mock.h"
+#include "pulse.h"
+#include "sdkconfig.h"
+#include "smf.h"
+#include "voice.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define CONTROL_RATE_HZ CONFIG_INTERRUPT_CONTROL_RATE_HZ
+#define TICK_NS (1000000000ULL / VOICE_TICK_HZ)
+
+// Mirrors audio.c and pwm.c
+#define ADC_RATE_HZ 16000
+#define LEDC_FREQUENCY 30000
+#define LEDC_PERIOD_NS (1000000000ULL / LEDC_FREQUENCY)
+#define LEDC_DUTY_STEPS 256
+
+#define WAV_RATE_HZ 48000
+#define WAV_GAIN 0.9
+#define WAV_HIGHPASS 0.999 // DC blocker pole, about 8 Hz at 48 kHz
+#define WAV_WINDOW 4096    // Samples kept open for pulses still running
+
+// Stop rendering if voices never go idle
+#define TAIL_MAX_US (10 * 1000000ULL)
+
+#define FNV_OFFSET 0xcbf29ce484222325ULL
+#define FNV_PRIME 0x100000001b3ULL
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+typedef struct
+{
+    FILE *vcd;
+    FILE *wav;
+
+    // WAV rendering, on-time in ns of the samples still open
+    double wav_acc[WAV_WINDOW];
+    uint64_t wav_next; // First sample not written yet
+    double hp_in;
+    double hp_out;
+
+    uint64_t now_ns;   // Virtual time of the output calls
+    uint8_t duty;      // Last duty set, applied at the next LEDC period
+    uint64_t limit_ns; // 0 when unlimited
+    uint64_t last_end_ns;
+    uint64_t pulses;
+    uint64_t on_ns;
+    uint64_t hash;
+} sim_t;
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static uint8_t *read_file(const char *path, size_t *size)
+{
+    FILE *f = fopen(path, "rb");
+    if (f == NULL)
+    {
+        perror(path);
+        exit(1);
+    }
+
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    uint8_t *data = malloc(len > 0 ? len : 1);
+    if (data == NULL || fread(data, 1, len, f) != (size_t)len)
+    {
+        perror(path);
+        exit(1);
+    }
+    fclose(f);
+
+    *size = len;
+    return data;
+}
+
+static uint32_t le32(const uint8_t *p)
+{
+    return p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static uint16_t le16(const uint8_t *p) { return p[0] | p[1] << 8; }
+
+static void put_le32(FILE *f, uint32_t v)
+{
+    uint8_t b[4] = {v, v >> 8, v >> 16, v >> 24};
+    fwrite(b, 1, 4, f);
+}
+
+static void put_le16(FILE *f, uint16_t v)
+{
+    uint8_t b[2] = {v, v >> 8};
+    fwrite(b, 1, 2, f);
+}
+
+static void wav_header(FILE *f, uint32_t samples)
+{
+    fwrite("RIFF", 1, 4, f);
+    put_le32(f, 36 + samples * 2);
+    fwrite("WAVEfmt ", 1, 8, f);
+    put_le32(f, 16);
+    put_le16(f, 1); // PCM
+    put_le16(f, 1); // Mono
+    put_le32(f, WAV_RATE_HZ);
+    put_le32(f, WAV_RATE_HZ * 2);
+    put_le16(f, 2);
+    put_le16(f, 16);
+    fwrite("data", 1, 4, f);
+    put_le32(f, samples * 2);
+}
+
+// Write the samples before `sample`, they cannot receive on-time anymore
+static void wav_flush(sim_t *sim, uint64_t sample)
+{
+    const double sample_ns = 1e9 / WAV_RATE_HZ;
+
+    for (; sim->wav_next < sample; sim->wav_next++)
+    {
+        double *acc = &sim->wav_acc[sim->wav_next % WAV_WINDOW];
+        double x = *acc / sample_ns;
+        *acc = 0;
+
+        sim->hp_out = WAV_HIGHPASS * (sim->hp_out + x - sim->hp_in);
+        sim->hp_in = x;
+
+        double y = sim->hp_out * WAV_GAIN * 32767;
+        if (y > 32767) y = 32767;
+        if (y < -32768) y = -32768;
+        put_le16(sim->wav, (int16_t)y);
+    }
+}
+
+static void wav_add(sim_t *sim, uint64_t start_ns, uint64_t end_ns)
+{
+    uint64_t s = start_ns * WAV_RATE_HZ / 1000000000ULL;
+    if (s > sim->wav_next) wav_flush(sim, s);
+
+    while (start_ns < end_ns)
+    {
+        uint64_t boundary = (s + 1) * 1000000000ULL / WAV_RATE_HZ;
+        uint64_t until = end_ns < boundary ? end_ns : boundary;
+        if (s - sim->wav_next >= WAV_WINDOW) wav_flush(sim, s - WAV_WINDOW + 1);
+        sim->wav_acc[s % WAV_WINDOW] += until - start_ns;
+        start_ns = until;
+        s++;
+    }
+}
+
+static void hash_u64(uint64_t *hash, uint64_t v)
+{
+    for (int i = 0; i < 8; i++)
+    {
+        *hash ^= (v >> (i * 8)) & 0xFF;
+        *hash *= FNV_PRIME;
+    }
+}
+
+// The simulated output pin, pulses come in time order
+static void sim_pulse(sim_t *sim, uint64_t start_ns, uint64_t width_ns)
+{
+    if (width_ns == 0) return;
+    if (start_ns < sim->last_end_ns)
+    {
+        fprintf(stderr, "sim: overlapping pulse at %llu ns\n",
+                (unsigned long long)start_ns);
+        start_ns = sim->last_end_ns;
+    }
+    uint64_t end_ns = start_ns + width_ns;
+
+    sim->pulses++;
+    sim->on_ns += width_ns;
+    sim->last_end_ns = end_ns;
+    hash_u64(&sim->hash, start_ns);
+    hash_u64(&sim->hash, width_ns);
+
+    if (sim->vcd)
+        fprintf(sim->vcd, "#%llu\n1!\n#%llu\n0!\n",
+                (unsigned long long)start_ns, (unsigned long long)end_ns);
+    if (sim->wav) wav_add(sim, start_ns, end_ns);
+}
+
+static void sim_mock_pulse(uint16_t width_tick, void *ctx)
+{
+    sim_t *sim = ctx;
+    sim_pulse(sim, sim->now_ns, width_tick * TICK_NS);
+}
+
+static void sim_mock_duty(uint8_t duty, void *ctx)
+{
+    sim_t *sim = ctx;
+    sim->duty = duty;
+}
+
+// MIDI mode, same loop as the control timer and pulse timer of the firmware
+static uint64_t run_midi(sim_t *sim, const uint8_t *data, size_t size)
+{
+    static smf_t smf;
+    if (smf_open(&smf, data, size) == 0)
+    {
+        fprintf(stderr, "sim: not a format 0/1 MIDI file\n");
+        exit(1);
+    }
+
+    const uint64_t ctrl_period = VOICE_TICK_HZ / CONTROL_RATE_HZ;
+    const uint64_t limit = sim->limit_ns / TICK_NS;
+
+    uint64_t t_ctrl = 0;
+    uint64_t t_alarm = PULSE_IDLE_POLL;
+    uint64_t t_last_event = 0;
+    pulse_sched_t sched;
+    pulse_sched_reset(&sched);
+
+    smf_event_t ev;
+    bool has_event = smf_next(&smf, &ev);
+
+    voice_init(CONTROL_RATE_HZ);
+
+    while (1)
+    {
+        if (t_ctrl <= t_alarm)
+        {
+            while (has_event && ev.time_us <= t_ctrl)
+            {
+                voice_handle_message(&ev.msg);
+                t_last_event = ev.time_us;
+                has_event = smf_next(&smf, &ev);
+            }
+            voice_tick();
+            t_ctrl += ctrl_period;
+
+            if (limit && t_ctrl >= limit) break;
+            // Held notes always have a pulse pending, the tail limit
+            // does not wait for one
+            if (!has_event && ((voice_active_count() == 0 &&
+                                sched.pending.width_tick == 0) ||
+                               t_ctrl > t_last_event + TAIL_MAX_US))
+                break;
+            continue;
+        }
+
+        uint64_t now = t_alarm;
+        uint32_t in;
+        uint16_t width =
+            pulse_sched_alarm(&sched, (uint32_t)now, voice_next_pulse, &in);
+        sim->now_ns = now * TICK_NS;
+        if (width > 0) output_pulse(width);
+        t_alarm = now + in;
+    }
+
+    return t_ctrl * TICK_NS;
+}
+
+// Audio mode: jack ADC samples, duty mapping, LEDC periods
+static uint64_t run_wav(sim_t *sim, const uint8_t *data, size_t size)
+{
+    uint16_t format = 0, channels = 0, bits = 0;
+    uint32_t rate = 0;
+    const uint8_t *pcm = NULL;
+    uint32_t pcm_size = 0;
+
+    if (size < 12 || memcmp(data + 8, "WAVE", 4)) goto error;
+    for (size_t pos = 12; pos + 8 <= size;)
+    {
+        uint32_t chunk = le32(data + pos + 4);
+        if (chunk > size - pos - 8) chunk = size - pos - 8;
+
+        if (memcmp(data + pos, "fmt ", 4) == 0 && chunk >= 16)
+        {
+            format = le16(data + pos + 8);
+            channels = le16(data + pos + 10);
+            rate = le32(data + pos + 12);
+            bits = le16(data + pos + 22);
+        }
+        else if (memcmp(data + pos, "data", 4) == 0)
+        {
+            pcm = data + pos + 8;
+            pcm_size = chunk;
+        }
+        pos += 8 + chunk + (chunk & 1);
+    }
+    if (format != 1 || channels < 1 || channels > 2 ||
+        (bits != 8 && bits != 16) || pcm == NULL || rate == 0)
+        goto error;
+
+    uint32_t frame = channels * bits / 8;
+    uint64_t frames = pcm_size / frame;
+    uint64_t duration_ns = frames * 1000000000ULL / rate;
+    if (sim->limit_ns && duration_ns > sim->limit_ns)
+        duration_ns = sim->limit_ns;
+
+    uint64_t next_adc_ns = 0;
+    uint64_t adc_count = 0;
+
+    for (uint64_t period = 0; period * LEDC_PERIOD_NS < duration_ns; period++)
+    {
+        uint64_t start_ns = period * LEDC_PERIOD_NS;
+
+        // Duty updates from the ADC callback apply at the next LEDC period
+        while (next_adc_ns <= start_ns)
+        {
+            uint64_t at = adc_count * rate / ADC_RATE_HZ;
+            const uint8_t *p = pcm + (at < frames ? at : frames - 1) * frame;
+            int32_t s = bits == 8 ? (p[0] - 128) << 8 : (int16_t)le16(p);
+
+            // 12 bit ADC reading around mid scale
+            int32_t raw = 2048 + (s >> 4);
+            if (raw < 0) raw = 0;
+            if (raw > 4095) raw = 4095;
+            sim->now_ns = next_adc_ns;
+            output_duty(pulse_duty(raw - 2048));
+
+            adc_count++;
+            next_adc_ns = adc_count * 1000000000ULL / ADC_RATE_HZ;
+        }
+
+        sim_pulse(sim, start_ns, LEDC_PERIOD_NS * sim->duty / LEDC_DUTY_STEPS);
+    }
+
+    return duration_ns;
+
+error:
+    fprintf(stderr, "sim: not a PCM 8/16 bit WAV file\n");
+    exit(1);
+}
+
+static double bench_ns(clock_t t0, uint32_t calls)
+{
+    return (double)(clock() - t0) / CLOCKS_PER_SEC * 1e9 / calls;
+}
+
+static int bench(uint32_t calls)
+{
+    output_init(&output_mock);
+    output_arm();
+
+    clock_t t0 = clock();
+    for (uint32_t i = 0; i < calls; i++) output_pulse(i & 0xFF);
+    double table = bench_ns(t0, calls);
+
+    // Through a volatile pointer so the direct call is not folded away
+    void (*volatile direct)(uint16_t) = output_mock_pulse;
+    t0 = clock();
+    for (uint32_t i = 0; i < calls; i++) direct(i & 0xFF);
+    double call = bench_ns(t0, calls);
+
+    printf("pulse: %.2f ns through the table, %.2f ns direct, %.2f ns "
+           "dispatch\n",
+           table, call, table - call);
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    if (argc == 3 && strcmp(argv[1], "-b") == 0)
+        return bench(strtoul(argv[2], NULL, 0));
+
+    static sim_t sim = {.hash = FNV_OFFSET};
+    const char *vcd_path = NULL;
+    const char *wav_path = NULL;
+    int arg = 1;
+
+    for (; arg + 1 < argc && argv[arg][0] == '-'; arg += 2)
+    {
+        if (strcmp(argv[arg], "-v") == 0)
+            vcd_path = argv[arg + 1];
+        else if (strcmp(argv[arg], "-w") == 0)
+            wav_path = argv[arg + 1];
+        else if (strcmp(argv[arg], "-t") == 0)
+            sim.limit_ns = (uint64_t)(atof(argv[arg + 1]) * 1e9);
+        else
+            break;
+    }
+
+    if (arg != argc - 1)
+    {
+        fprintf(stderr, "usage: sim [-v out.vcd] [-w out.wav] [-t seconds] "
+                        "<in.mid | in.wav>\n"
+                        "       sim -b <calls>\n");
+        return 2;
+    }
+
+    size_t size;
+    uint8_t *data = read_file(argv[arg], &size);
+    bool midi = size >= 4 && memcmp(data, "MThd", 4) == 0;
+    if (!midi && (size < 4 || memcmp(data, "RIFF", 4)))
+    {
+        fprintf(stderr, "sim: %s: neither a MIDI nor a WAV file\n", argv[arg]);
+        return 1;
+    }
+
+    if (vcd_path)
+    {
+        sim.vcd = fopen(vcd_path, "w");
+        if (sim.vcd == NULL)
+        {
+            perror(vcd_path);
+            return 1;
+        }
+        fprintf(sim.vcd, "$timescale 1ns $end\n"
+                         "$scope module interrupter $end\n"
+                         "$var wire 1 ! out $end\n"
+                         "$upscope $end\n"
+                         "$enddefinitions $end\n"
+                         "#0\n0!\n");
+    }
+    if (wav_path)
+    {
+        sim.wav = fopen(wav_path, "wb");
+        if (sim.wav == NULL)
+        {
+            perror(wav_path);
+            return 1;
+        }
+        wav_header(sim.wav, 0); // Sizes patched once the length is known
+    }
+
+    output_mock_hooks_t hooks = {
+        .pulse = sim_mock_pulse, .duty = sim_mock_duty, .ctx = &sim};
+    output_mock_set_hooks(&hooks);
+    output_init(&output_mock);
+    output_arm();
+
+    clock_t t0 = clock();
+    uint64_t duration_ns = midi ? run_midi(&sim, data, size)
+                                : run_wav(&sim, data, size);
+    double cpu_s = (double)(clock() - t0) / CLOCKS_PER_SEC;
+
+    if (sim.vcd) fclose(sim.vcd);
+    if (sim.wav)
+    {
+        uint64_t end = duration_ns > sim.last_end_ns ? duration_ns
+                                                     : sim.last_end_ns;
+        wav_flush(&sim, end * WAV_RATE_HZ / 1000000000ULL + 1);
+        fseek(sim.wav, 0, SEEK_SET);
+        wav_header(sim.wav, (uint32_t)sim.wav_next);
+        fclose(sim.wav);
+    }
+
+    double seconds = duration_ns / 1e9;
+    printf("%s mode, %llu pulses, %.3f s, duty %.2f%%, %.0fx real time, "
+           "hash %016llx\n",
+           midi ? "MIDI" : "audio", (unsigned long long)sim.pulses, seconds,
+           seconds > 0 ? 100.0 * sim.on_ns / duration_ns : 0.0,
+           cpu_s > 0 ? seconds / cpu_s : 0.0, (unsigned long long)sim.hash);
+
+    free(data);
+    return 0;
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file check.h
+ * @brief Assertions of the host tests
+ *
+ * A failed CHECK prints where and why and the test goes on, so one run
+ * lists every failure. CHECK_DONE() is the exit status for ctest.
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+#ifndef CHECK_H
+#define CHECK_H
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include <stdio.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+static int check_failures = 0;
+
+#define CHECK(cond, ...)                                                       \
+    do                                                                         \
+    {                                                                          \
+        if (!(cond))                                                           \
+        {                                                                      \
+            fprintf(stderr, "%s:%d: ", __FILE__, __LINE__);                    \
+            fprintf(stderr, __VA_ARGS__);                                      \
+            fputc('\n', stderr);                                               \
+            check_failures++;                                                  \
+        }                                                                      \
+    } while (0)
+
+#define CHECK_DONE()                                                           \
+    (check_failures ? (fprintf(stderr, "%d failed\n", check_failures), 1) : 0)
+
+#endif /* !CHECK_H */
@@ -0,0 +1,29 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file esp_timer.h
+ * @brief Host stand-in for the IDF timer, the test sets the time
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+#ifndef ESP_TIMER_H
+#define ESP_TIMER_H
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+int64_t esp_timer_get_time(void);
+
+#endif /* !ESP_TIMER_H */
@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file test_midi_parse.c
+ * @brief MIDI byte stream parser against hand written streams
+ *
+ * Each case feeds a byte stream through midi_parser_feed() and compares
+ * the messages it returns, formatted one per line, with the expected
+ * ones: running status, realtime bytes inside a message, sysex, system
+ * common messages and the one data byte messages.
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "check.h"
+#include "midi_parse.h"
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define OUT_LEN 512
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+typedef struct
+{
+    const char *name;
+    uint8_t bytes[32];
+    uint8_t length;
+    const char *expected; // One message per line
+} parse_case_t;
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static const parse_case_t cases[] = {
+    {"running status",
+     {0x90, 60, 100, 64, 90, 67, 0, 0x80, 60, 0, 62, 1},
+     12,
+     "note_on 0 60 100\nnote_on 0 64 90\nnote_off 0 67 0\n"
+     "note_off 0 60 0\nnote_off 0 62 0\n"},
+    {"realtime inside a message",
+     {0x91, 0xF8, 60, 0xFA, 100, 62, 0xF8, 0xFC, 80},
+     9,
+     "clock\nstart\nnote_on 1 60 100\nclock\nstop\nnote_on 1 62 80\n"},
+    {"sysex skipped",
+     {0xB2, 7, 100, 0xF0, 0x7E, 0x10, 0x90, 60, 0xF8, 0xF7, 0xB2, 1, 64},
+     13,
+     "cc 2 7 100\nclock\ncc 2 1 64\n"},
+    {"sysex ended by a status",
+     {0xF0, 0x43, 0x12, 0x93, 60, 100},
+     6,
+     "note_on 3 60 100\n"},
+    {"system common cancels running status",
+     {0x90, 60, 100, 0xF2, 0x10, 0x20, 62, 100, 0xF3, 5, 0xF6, 64, 100,
+      0xF1, 0x7F, 0x90, 65, 100},
+     18,
+     "note_on 0 60 100\nnote_on 0 65 100\n"},
+    {"one data byte messages",
+     {0xC4, 5, 6, 0xD4, 100, 90, 0xC4, 7, 0xE4, 0x00, 0x40, 0x7F, 0x7F},
+     13,
+     "program 4 5\nprogram 4 6\nprogram 4 7\nbend 4 0\nbend 4 8191\n"},
+    {"data before any status",
+     {60, 100, 0x95, 61, 100},
+     5,
+     "note_on 5 61 100\n"},
+};
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static void format_message(const midi_message_t *m, char *line, size_t size)
+{
+    switch (m->type)
+    {
+    case MIDI_MSG_NOTE:
+        snprintf(line, size, "%s %u %u %u\n",
+                 m->state ? "note_on" : "note_off", m->channel, m->note,
+                 m->velocity);
+        break;
+    case MIDI_MSG_CONTROL_CHANGE:
+        snprintf(line, size, "cc %u %u %u\n", m->channel, m->note,
+                 m->velocity);
+        break;
+    case MIDI_MSG_PROGRAM_CHANGE:
+        snprintf(line, size, "program %u %u\n", m->channel, m->note);
+        break;
+    case MIDI_MSG_PITCH_BEND:
+        snprintf(line, size, "bend %u %d\n", m->channel, m->bend);
+        break;
+    case MIDI_MSG_CLOCK:
+        snprintf(line, size, "clock\n");
+        break;
+    case MIDI_MSG_START:
+        snprintf(line, size, "start\n");
+        break;
+    case MIDI_MSG_CONTINUE:
+        snprintf(line, size, "continue\n");
+        break;
+    case MIDI_MSG_STOP:
+        snprintf(line, size, "stop\n");
+        break;
+    default:
+        snprintf(line, size, "other %d\n", m->type);
+        break;
+    }
+}
+
+static void check_case(const parse_case_t *c)
+{
+    midi_parser_t parser;
+    midi_parser_init(&parser);
+
+    char out[OUT_LEN] = "";
+    for (int i = 0; i < c->length; i++)
+    {
+        midi_message_t msg;
+        if (!midi_parser_feed(&parser, c->bytes[i], &msg)) continue;
+
+        char line[64];
+        format_message(&msg, line, sizeof(line));
+        strncat(out, line, sizeof(out) - strlen(out) - 1);
+    }
+
+    CHECK(strcmp(out, c->expected) == 0, "%s: got\n%sexpected\n%s", c->name,
+          out, c->expected);
+}
+
+// What midi_encode() packs, the parser reads back
+static void check_round_trip(void)
+{
+    const midi_message_t messages[] = {
+        {.type = MIDI_MSG_NOTE, .channel = 9, .state = true, .note = 36,
+         .velocity = 127},
+        {.type = MIDI_MSG_CONTROL_CHANGE, .channel = 15, .note = 64,
+         .velocity = 0},
+        {.type = MIDI_MSG_PITCH_BEND, .channel = 1, .bend = -8192},
+        {.type = MIDI_MSG_PROGRAM_CHANGE, .channel = 2, .note = 99},
+    };
+
+    for (size_t i = 0; i < sizeof(messages) / sizeof(messages[0]); i++)
+    {
+        uint8_t bytes[3];
+        CHECK(midi_encode(&messages[i], bytes), "message %zu not encoded", i);
+
+        midi_parser_t parser;
+        midi_parser_init(&parser);
+        midi_message_t decoded;
+        bool got = false;
+        uint8_t length = 1 + midi_data_length(bytes[0]);
+        for (int b = 0; b < length; b++)
+            got = midi_parser_feed(&parser, bytes[b], &decoded);
+
+        char want[64];
+        char line[64];
+        format_message(&messages[i], want, sizeof(want));
+        format_message(&decoded, line, sizeof(line));
+        CHECK(got && strcmp(line, want) == 0, "encoded %s read back as %s",
+              want, got ? line : "nothing\n");
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+int main(void)
+{
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+        check_case(&cases[i]);
+    check_round_trip();
+    return CHECK_DONE();
+}
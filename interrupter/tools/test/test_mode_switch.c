@@ -0,0 +1,203 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file test_mode_switch.c
+ * @brief Output mode transitions against the mock backend
+ *
+ * output_mock stands in for the RMT backend of the pulse modes and a
+ * recording backend for the LEDC one of the duty modes. Every backend
+ * call and mode hook is logged in order, so each transition is checked
+ * against the exact sequence: leave, stop, hand the pin over when armed,
+ * start, enter. Without a duty backend, audio and clips must be refused
+ * without a single call.
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "check.h"
+#include "mode_switch.h"
+#include "output_mock.h"
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define LOG_LEN 512
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+typedef struct
+{
+    pwm_mode_t mode;
+    bool switched;
+    const char *expected; // Calls, comma separated
+} transition_t;
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static char log_text[LOG_LEN];
+
+static const char *const mode_names[] = {
+    [PWM_MANUAL] = "manual",
+    [PWM_AUDIO] = "audio",
+    [PWM_MIDI] = "midi",
+    [PWM_CLIPS] = "clips",
+};
+
+// Armed, from the manual mode
+static const transition_t transitions[] = {
+    {PWM_MIDI, true, "leave manual, mock stop, mock start, enter midi"},
+    {PWM_MIDI, false, ""},
+    {PWM_AUDIO, true,
+     "leave midi, mock stop, mock disarm, ledc arm, ledc start, enter audio"},
+    {PWM_CLIPS, true, "leave audio, ledc stop, ledc start, enter clips"},
+    {PWM_MIDI, true,
+     "leave clips, ledc stop, ledc disarm, mock arm, mock start, enter midi"},
+    {PWM_MANUAL, true, "leave midi, mock stop, mock start, enter manual"},
+    {PWM_CLIPS, true,
+     "leave manual, mock stop, mock disarm, ledc arm, ledc start, "
+     "enter clips"},
+    {PWM_MANUAL, true,
+     "leave clips, ledc stop, ledc disarm, mock arm, mock start, "
+     "enter manual"},
+};
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static void log_call(const char *fmt, const char *a, const char *b)
+{
+    size_t used = strlen(log_text);
+    if (used > 0)
+        used += snprintf(log_text + used, sizeof(log_text) - used, ", ");
+    snprintf(log_text + used, sizeof(log_text) - used, fmt, a, b);
+}
+
+static void mock_call(const char *op, void *ctx)
+{
+    (void)ctx;
+    log_call("%s %s", "mock", op);
+}
+
+static void ledc_init(void) {}
+static void ledc_start(void) { log_call("%s %s", "ledc", "start"); }
+static void ledc_stop(void) { log_call("%s %s", "ledc", "stop"); }
+static void ledc_arm(void) { log_call("%s %s", "ledc", "arm"); }
+static void ledc_disarm(void) { log_call("%s %s", "ledc", "disarm"); }
+static void ledc_pulse(uint16_t width_tick) { (void)width_tick; }
+static void ledc_duty(uint8_t duty) { (void)duty; }
+
+static void ledc_train(uint32_t period_tick, uint32_t width_tick)
+{
+    (void)period_tick;
+    (void)width_tick;
+}
+
+static const output_backend_t output_duty_stand_in = {
+    .name = "ledc",
+    .init = ledc_init,
+    .start = ledc_start,
+    .stop = ledc_stop,
+    .arm = ledc_arm,
+    .disarm = ledc_disarm,
+    .pulse = ledc_pulse,
+    .train = ledc_train,
+    .duty = ledc_duty,
+    .train_max_tick = 0,
+};
+
+static void mode_leave(pwm_mode_t mode, void *ctx)
+{
+    (void)ctx;
+    log_call("%s %s", "leave", mode_names[mode]);
+}
+
+static void mode_enter(pwm_mode_t mode, void *ctx)
+{
+    (void)ctx;
+    log_call("%s %s", "enter", mode_names[mode]);
+}
+
+static const mode_switch_hooks_t hooks = {
+    .leave = mode_leave,
+    .enter = mode_enter,
+};
+
+static void check_transitions(void)
+{
+    mode_switch_t sw;
+
+    log_text[0] = '\0';
+    mode_switch_init(&sw, PWM_MANUAL, &output_mock, &output_duty_stand_in,
+                     &hooks);
+    CHECK(strcmp(log_text, "mock disarm") == 0, "init: %s", log_text);
+    CHECK(mode_switch_backend(&sw, PWM_AUDIO) == &output_duty_stand_in &&
+              mode_switch_backend(&sw, PWM_MIDI) == &output_mock,
+          "backends of the modes");
+
+    output_arm();
+
+    for (size_t i = 0; i < sizeof(transitions) / sizeof(transitions[0]); i++)
+    {
+        const transition_t *t = &transitions[i];
+        pwm_mode_t from = sw.mode;
+
+        log_text[0] = '\0';
+        bool switched = mode_switch_set(&sw, t->mode);
+        CHECK(switched == t->switched && sw.mode == t->mode,
+              "%s to %s: %s", mode_names[from], mode_names[t->mode],
+              switched ? "switched" : "not switched");
+        CHECK(strcmp(log_text, t->expected) == 0, "%s to %s: got\n%s\n"
+              "expected\n%s", mode_names[from], mode_names[t->mode],
+              log_text, t->expected);
+    }
+
+    // Disarmed, neither backend has the pin to hand over
+    output_disarm();
+    log_text[0] = '\0';
+    mode_switch_set(&sw, PWM_AUDIO);
+    const char *expected = "leave manual, mock stop, ledc start, enter audio";
+    CHECK(strcmp(log_text, expected) == 0, "disarmed switch: %s", log_text);
+}
+
+static void check_no_duty_backend(void)
+{
+    mode_switch_t sw;
+    mode_switch_init(&sw, PWM_MANUAL, &output_mock, NULL, &hooks);
+
+    const pwm_mode_t refused[] = {PWM_AUDIO, PWM_CLIPS};
+    for (size_t i = 0; i < 2; i++)
+    {
+        log_text[0] = '\0';
+        CHECK(!mode_switch_set(&sw, refused[i]), "%s accepted",
+              mode_names[refused[i]]);
+        CHECK(sw.mode == PWM_MANUAL && log_text[0] == '\0',
+              "refused %s: %s", mode_names[refused[i]], log_text);
+    }
+
+    CHECK(mode_switch_set(&sw, PWM_MIDI), "MIDI refused without LEDC");
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+int main(void)
+{
+    const output_mock_hooks_t mock_hooks = {.call = mock_call};
+    output_mock_set_hooks(&mock_hooks);
+
+    check_transitions();
+    check_no_duty_backend();
+    return CHECK_DONE();
+}
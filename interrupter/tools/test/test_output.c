@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file test_output.c
+ * @brief Output backend switching through the mock
+ *
+ * output_init(), output_select(), output_arm() and output_disarm() are
+ * driven between output_mock and a second counting backend, the stand-in
+ * for the RMT and LEDC pair of the firmware. The pin must always belong to
+ * one backend: armed on the one in use and disarmed on the one left, and
+ * never touched while the output is disarmed.
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "check.h"
+#include "output.h"
+#include "output_mock.h"
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static struct
+{
+    uint32_t arms;
+    uint32_t disarms;
+    uint32_t pulses;
+} other_state;
+
+static uint32_t hook_pulses;
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static void other_nop(void) {}
+static void other_arm(void) { other_state.arms++; }
+static void other_disarm(void) { other_state.disarms++; }
+static void other_duty(uint8_t duty) { (void)duty; }
+
+static void other_pulse(uint16_t width_tick)
+{
+    (void)width_tick;
+    other_state.pulses++;
+}
+
+static void other_train(uint32_t period_tick, uint32_t width_tick)
+{
+    (void)period_tick;
+    (void)width_tick;
+}
+
+static const output_backend_t output_other = {
+    .name = "other",
+    .init = other_nop,
+    .start = other_nop,
+    .stop = other_nop,
+    .arm = other_arm,
+    .disarm = other_disarm,
+    .pulse = other_pulse,
+    .train = other_train,
+    .duty = other_duty,
+    .train_max_tick = 1000,
+};
+
+static void hook_pulse(uint16_t width_tick, void *ctx)
+{
+    (void)width_tick;
+    (void)ctx;
+    hook_pulses++;
+}
+
+static void check_arm(void)
+{
+    const output_mock_state_t *mock = output_mock_get_state();
+
+    output_mock_init();
+    output_init(&output_mock);
+    CHECK(!output_is_armed(), "armed after init");
+    CHECK(mock->disarms == 1 && !mock->armed, "pin not released by init");
+
+    // Counted either way, only reaches the pin once armed
+    output_pulse(10);
+    CHECK(mock->pulses == 1 && hook_pulses == 0, "pulse out while disarmed");
+
+    output_arm();
+    CHECK(output_is_armed() && mock->arms == 1, "arm not passed on");
+    output_pulse(20);
+    CHECK(mock->pulses == 2 && hook_pulses == 1, "pulse lost while armed");
+    CHECK(mock->on_tick == 30, "mock on time %llu",
+          (unsigned long long)mock->on_tick);
+    CHECK(output_counters.pulses == 2 && output_counters.on_tick == 30,
+          "counters %u pulses, %u ticks", output_counters.pulses,
+          output_counters.on_tick);
+
+    output_disarm();
+    CHECK(!output_is_armed() && mock->disarms == 2 && !mock->armed,
+          "disarm not passed on");
+}
+
+static void check_select(void)
+{
+    const output_mock_state_t *mock = output_mock_get_state();
+
+    output_mock_init();
+    output_init(&output_mock);
+    output_arm();
+
+    // Armed: the pin moves from one backend to the other
+    output_select(&output_other);
+    CHECK(output_is_armed(), "select disarmed the output");
+    CHECK(mock->disarms == 2 && !mock->armed, "old backend still armed");
+    CHECK(other_state.arms == 1, "new backend not armed");
+    CHECK(output_train_max() == 1000, "train limit of the old backend");
+
+    output_pulse(5);
+    CHECK(other_state.pulses == 1 && mock->pulses == 0,
+          "pulse on the old backend");
+
+    // Same backend again, nothing to hand over
+    output_select(&output_other);
+    CHECK(other_state.arms == 1 && other_state.disarms == 0,
+          "reselect touched the pin");
+
+    // Disarmed: switching leaves both backends alone
+    output_disarm();
+    CHECK(other_state.disarms == 1, "disarm not passed on");
+    output_select(&output_mock);
+    CHECK(mock->arms == 1 && other_state.disarms == 1,
+          "disarmed select touched the pin");
+    CHECK(!output_is_armed(), "select armed the output");
+
+    output_arm();
+    CHECK(mock->arms == 2 && mock->armed, "arm after select not passed on");
+}
+
+static void check_stop(void)
+{
+    const output_mock_state_t *mock = output_mock_get_state();
+
+    output_mock_init();
+    output_init(&output_mock);
+    output_start();
+    output_train(400, 20);
+    CHECK(mock->starts == 1, "start not passed on");
+    CHECK(output_counters.train_period_tick == 400 &&
+              output_counters.train_width_tick == 20,
+          "train not counted");
+
+    output_stop();
+    CHECK(mock->stops == 1 && mock->period_tick == 0, "stop not passed on");
+    CHECK(output_counters.train_period_tick == 0, "train counted after stop");
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+int main(void)
+{
+    const output_mock_hooks_t hooks = {.pulse = hook_pulse};
+    output_mock_set_hooks(&hooks);
+
+    check_arm();
+    check_select();
+    check_stop();
+    return CHECK_DONE();
+}
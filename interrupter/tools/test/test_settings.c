@@ -0,0 +1,213 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file test_settings.c
+ * @brief Settings store against an in-memory NVS
+ *
+ * settings.c is built with the headers of stub/ and the NVS calls below,
+ * which keep the blobs in memory and count the writes, on a clock the test
+ * advances. A knob spin stages a changed snapshot on every step; however
+ * long the spin, settings_poll() must write once, after the settle time.
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "check.h"
+#include "esp_timer.h"
+#include "nvs.h"
+#include "settings.h"
+#include <stdbool.h>
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define SETTLE_US (CONFIG_INTERRUPT_SETTINGS_SETTLE_MS * 1000LL)
+
+#define KNOB_STEPS 300
+#define KNOB_STEP_US 10000 // 100 detents per second
+#define POLL_US 10000      // Menu loop
+
+#define NVS_KEYS 8
+#define NVS_BLOB_MAX (SETTINGS_RECORDS * sizeof(settings_record_t))
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static int64_t now_us;
+
+static struct
+{
+    char key[NVS_KEY_NAME_MAX_SIZE];
+    uint8_t blob[NVS_BLOB_MAX];
+    size_t length;
+} nvs[NVS_KEYS];
+static int nvs_count;
+static int nvs_writes;
+static int nvs_failures; // Next writes to fail
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static int nvs_find(const char *key)
+{
+    for (int i = 0; i < nvs_count; i++)
+        if (strcmp(nvs[i].key, key) == 0) return i;
+    return -1;
+}
+
+static void advance(int64_t us)
+{
+    for (int64_t t = 0; t < us; t += POLL_US)
+    {
+        now_us += POLL_US;
+        settings_poll();
+    }
+}
+
+static void check_knob_spin(void)
+{
+    settings_record_t records[2] = {{"PD", 10}, {"PRF", 1000}};
+    settings_stats_t stats;
+
+    // Every step changes the value and restarts the wait
+    for (int i = 0; i < KNOB_STEPS; i++)
+    {
+        records[1].value = 1000 + i;
+        settings_stage(records, 2);
+        advance(KNOB_STEP_US);
+    }
+    CHECK(nvs_writes == 0, "%d writes during the spin", nvs_writes);
+
+    advance(SETTLE_US - KNOB_STEP_US - POLL_US);
+    CHECK(nvs_writes == 0, "written before the settle time");
+    advance(2 * POLL_US);
+    CHECK(nvs_writes == 1, "%d writes for %d steps", nvs_writes, KNOB_STEPS);
+
+    settings_get_stats(&stats);
+    CHECK(stats.staged == KNOB_STEPS && stats.writes == 1,
+          "stats: %u staged, %u writes", stats.staged, stats.writes);
+
+    // The last step is what flash holds
+    settings_record_t read[SETTINGS_RECORDS];
+    size_t count = settings_read(SETTINGS_CURRENT, read, SETTINGS_RECORDS);
+    CHECK(count == 2 && memcmp(read, records, sizeof(records)) == 0,
+          "%zu records read back", count);
+
+    // Staging what is stored again is no change
+    settings_stage(records, 2);
+    advance(2 * SETTLE_US);
+    CHECK(nvs_writes == 1, "unchanged settings written");
+}
+
+static void check_retry(void)
+{
+    settings_record_t records[1] = {{"PD", 42}};
+    int writes = nvs_writes;
+
+    nvs_failures = 1;
+    settings_stage(records, 1);
+    advance(SETTLE_US + POLL_US);
+    CHECK(nvs_writes == writes, "failed write counted");
+
+    // Tried again one settle time later
+    advance(SETTLE_US + POLL_US);
+    CHECK(nvs_writes == writes + 1, "failed write not retried");
+}
+
+static void check_presets(void)
+{
+    const settings_record_t records[1] = {{"PD", 77}};
+    int writes = nvs_writes;
+
+    CHECK(settings_write(2, records, 1) == ESP_OK, "preset not saved");
+    CHECK(nvs_writes == writes + 1, "preset write deferred");
+    CHECK(nvs_find("preset2") >= 0, "preset stored under another key");
+
+    settings_record_t read[SETTINGS_RECORDS];
+    CHECK(settings_read(2, read, SETTINGS_RECORDS) == 1 && read[0].value == 77,
+          "preset not read back");
+    CHECK(settings_read(3, read, SETTINGS_RECORDS) == 0,
+          "empty preset read back");
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+int64_t esp_timer_get_time(void) { return now_us; }
+
+const char *esp_err_to_name(esp_err_t err) { return err ? "error" : "ok"; }
+
+esp_err_t nvs_open(const char *name, nvs_open_mode_t mode,
+                   nvs_handle_t *handle)
+{
+    (void)name;
+    (void)mode;
+    *handle = 1;
+    return ESP_OK;
+}
+
+void nvs_close(nvs_handle_t handle) { (void)handle; }
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char *key, void *out,
+                       size_t *length)
+{
+    (void)handle;
+    int i = nvs_find(key);
+    if (i < 0) return ESP_ERR_NVS_NOT_FOUND;
+    if (*length < nvs[i].length) return ESP_FAIL;
+
+    memcpy(out, nvs[i].blob, nvs[i].length);
+    *length = nvs[i].length;
+    return ESP_OK;
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char *key,
+                       const void *value, size_t length)
+{
+    (void)handle;
+    if (nvs_failures > 0)
+    {
+        nvs_failures--;
+        return ESP_FAIL;
+    }
+
+    int i = nvs_find(key);
+    if (i < 0)
+    {
+        if (nvs_count == NVS_KEYS || length > NVS_BLOB_MAX) return ESP_FAIL;
+        i = nvs_count++;
+        strncpy(nvs[i].key, key, NVS_KEY_NAME_MAX_SIZE - 1);
+    }
+    memcpy(nvs[i].blob, value, length);
+    nvs[i].length = length;
+    nvs_writes++;
+    return ESP_OK;
+}
+
+esp_err_t nvs_commit(nvs_handle_t handle)
+{
+    (void)handle;
+    return ESP_OK;
+}
+
+int main(void)
+{
+    settings_record_t read[SETTINGS_RECORDS];
+    CHECK(settings_read(SETTINGS_CURRENT, read, SETTINGS_RECORDS) == 0,
+          "settings read from an empty store");
+
+    check_knob_spin();
+    check_retry();
+    check_presets();
+    return CHECK_DONE();
+}
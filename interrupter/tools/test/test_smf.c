@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file test_smf.c
+ * @brief Standard MIDI File reader against reference files
+ *
+ * Each reference file in the data directory comes with the events it must
+ * produce, one per line: time in us, type, channel and the two data bytes.
+ * The files cover format 0 and 1, tempo changes, running status, sysex and
+ * unknown chunks, simultaneous events across tracks and SMPTE time. Every
+ * file is read twice, the second time after smf_rewind().
+ *
+ * Usage:
+ *   test_smf <data directory>
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "check.h"
+#include "smf.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define MAX_FILE 4096
+#define LINE_LEN 96
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static const char *references[] = {"format0", "format1", "smpte"};
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static size_t load(const char *path, uint8_t *buf, size_t max)
+{
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) return 0;
+    size_t len = fread(buf, 1, max, f);
+    fclose(f);
+    return len;
+}
+
+static void format_event(const smf_event_t *e, char *line, size_t size)
+{
+    const midi_message_t *m = &e->msg;
+    switch (m->type)
+    {
+    case MIDI_MSG_NOTE:
+        snprintf(line, size, "%" PRIu64 " %s %u %u %u", e->time_us,
+                 m->state ? "note_on" : "note_off", m->channel, m->note,
+                 m->velocity);
+        break;
+    case MIDI_MSG_CONTROL_CHANGE:
+        snprintf(line, size, "%" PRIu64 " cc %u %u %u", e->time_us,
+                 m->channel, m->note, m->velocity);
+        break;
+    case MIDI_MSG_PITCH_BEND:
+        snprintf(line, size, "%" PRIu64 " bend %u %d 0", e->time_us,
+                 m->channel, m->bend);
+        break;
+    case MIDI_MSG_PROGRAM_CHANGE:
+        snprintf(line, size, "%" PRIu64 " program %u %u 0", e->time_us,
+                 m->channel, m->note);
+        break;
+    default:
+        snprintf(line, size, "%" PRIu64 " other %d", e->time_us, m->type);
+        break;
+    }
+}
+
+// Next expected event, comments and blank lines skipped
+static bool next_expected(FILE *f, char *line, size_t size)
+{
+    while (fgets(line, size, f))
+    {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] != '\0' && line[0] != '#') return true;
+    }
+    return false;
+}
+
+static void check_reference(const char *dir, const char *name)
+{
+    static uint8_t data[MAX_FILE];
+    char path[512];
+
+    snprintf(path, sizeof(path), "%s/%s.mid", dir, name);
+    size_t size = load(path, data, sizeof(data));
+    CHECK(size > 0, "%s: cannot read", path);
+    if (size == 0) return;
+
+    smf_t smf;
+    size_t len = smf_open(&smf, data, size);
+    CHECK(len == size, "%s: %zu of %zu bytes parsed", name, len, size);
+
+    for (int pass = 0; pass < 2; pass++)
+    {
+        snprintf(path, sizeof(path), "%s/%s.txt", dir, name);
+        FILE *f = fopen(path, "r");
+        CHECK(f != NULL, "%s: cannot read", path);
+        if (f == NULL) return;
+
+        char expected[LINE_LEN];
+        char got[LINE_LEN];
+        smf_event_t event;
+        int index = 0;
+        bool more = next_expected(f, expected, sizeof(expected));
+
+        while (smf_next(&smf, &event))
+        {
+            format_event(&event, got, sizeof(got));
+            CHECK(more, "%s: extra event %d '%s'", name, index, got);
+            if (!more) break;
+            CHECK(strcmp(got, expected) == 0,
+                  "%s: event %d is '%s', expected '%s'", name, index, got,
+                  expected);
+            more = next_expected(f, expected, sizeof(expected));
+            index++;
+        }
+        CHECK(!more, "%s: missing event %d '%s'", name, index, expected);
+        fclose(f);
+
+        smf_rewind(&smf);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    if (argc != 2)
+    {
+        fprintf(stderr, "usage: test_smf <data directory>\n");
+        return 2;
+    }
+
+    for (size_t i = 0; i < sizeof(references) / sizeof(references[0]); i++)
+        check_reference(argv[1], references[i]);
+
+    // Not a MIDI file, or a format the reader does not play
+    static const uint8_t format2[] = {'M', 'T', 'h', 'd', 0, 0, 0, 6,
+                                      0,   2,   0,   1,   0, 96};
+    smf_t smf;
+    CHECK(smf_open(&smf, format2, sizeof(format2)) == 0,
+          "format 2 file accepted");
+    CHECK(smf_open(&smf, (const uint8_t *)"RIFF", 4) == 0,
+          "non MIDI data accepted");
+
+    return CHECK_DONE();
+}
@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file test_voice.c
+ * @brief Note to period path of the voice engine against double precision
+ *
+ * voice_pitch_to_period() is swept over the whole pitch range, bent notes
+ * included, then the periods voice_tick() publishes are read back through
+ * the pulse scheduler interface, with pitch bend and vibrato. Tolerances
+ * are the ones gen_tables.py checks its tables with. Patches compiled from
+ * out of range presets stay within the coil limits of the build.
+ *
+ * @author Stanley Arnaud
+ * @date 10/18/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "check.h"
+#include "sdkconfig.h"
+#include "voice.h"
+#include <math.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define CONTROL_RATE CONFIG_INTERRUPT_CONTROL_RATE_HZ
+#define PITCH_MAX ((127 + 24) << VOICE_PITCH_SHIFT)
+
+#define MAX_ERR_LSB 1.0  // Rounding of the note table and of the Q8 result
+#define MAX_REL_ERR 5e-6 // Linear interpolation of the fine table
+#define MAX_CENTS 0.01   // Published periods, one Q8 LSB at the top notes
+
+#define SETTLE_TICKS                                                           \
+    ((CONFIG_INTERRUPT_ENV_ATTACK_MS + CONFIG_INTERRUPT_ENV_DECAY_MS) *       \
+         CONTROL_RATE / 1000 +                                                 \
+     10)
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static double exact_period_q8(double semitones)
+{
+    double freq = 440.0 * pow(2.0, (semitones - 69.0) / 12.0);
+    return VOICE_TICK_HZ / freq * (1 << VOICE_PERIOD_SHIFT);
+}
+
+static double cents(double period_q8, double reference_q8)
+{
+    return 1200.0 * log2(reference_q8 / period_q8);
+}
+
+// Period of the voice after each control tick, one pulse per tick
+static void run_ticks(uint32_t *periods, int count)
+{
+    voice_pulse_t pulse;
+    voice_tick();
+    CHECK(voice_next_pulse(0, &pulse), "no pulse from a held note");
+    uint32_t at = pulse.at_q8;
+
+    for (int i = 0; i < count; i++)
+    {
+        voice_tick();
+        CHECK(voice_next_pulse(at, &pulse), "no pulse at tick %d", i);
+        periods[i] = pulse.at_q8 - at;
+        at = pulse.at_q8;
+    }
+}
+
+static void check_pitch_sweep(void)
+{
+    double worst = 0.0;
+    int32_t worst_pitch = 0;
+
+    for (int32_t pitch = 0; pitch <= PITCH_MAX; pitch += 61)
+    {
+        double exact = exact_period_q8(pitch / 65536.0);
+        double err = fabs(voice_pitch_to_period(pitch) - exact);
+        double ratio = err / (MAX_ERR_LSB + MAX_REL_ERR * exact);
+        if (ratio > worst)
+        {
+            worst = ratio;
+            worst_pitch = pitch;
+        }
+    }
+    CHECK(worst <= 1.0, "pitch %.4f off by %.2fx the tolerance",
+          worst_pitch / 65536.0, worst);
+
+    // Out of range pitches are clamped, not wrapped
+    CHECK(voice_pitch_to_period(-1) == voice_pitch_to_period(0),
+          "negative pitch not clamped");
+    CHECK(voice_pitch_to_period(PITCH_MAX + 65536) ==
+              voice_pitch_to_period(PITCH_MAX),
+          "pitch above the bend range not clamped");
+}
+
+static void check_tick_periods(void)
+{
+    static uint32_t periods[4 * CONTROL_RATE];
+
+    voice_init(CONTROL_RATE);
+    voice_note_on(0, 69, 127);
+    for (int i = 0; i < SETTLE_TICKS; i++) voice_tick();
+
+    // Plain note
+    run_ticks(periods, 16);
+    for (int i = 0; i < 16; i++)
+        CHECK(fabs(cents(periods[i], exact_period_q8(69))) < MAX_CENTS,
+              "A4 published as %u", (unsigned)periods[i]);
+
+    // Full bend up
+    voice_set_pitch_bend(8191);
+    double bent = 69 + CONFIG_INTERRUPT_PITCH_BEND_RANGE * 8191.0 / 8192.0;
+    run_ticks(periods, 16);
+    for (int i = 1; i < 16; i++)
+        CHECK(fabs(cents(periods[i], exact_period_q8(bent))) < MAX_CENTS,
+              "bent A4 published as %u", (unsigned)periods[i]);
+    voice_set_pitch_bend(0);
+
+    // Vibrato swings the full depth around the note, and no further
+    voice_set_modulation(127);
+    run_ticks(periods, 4 * CONTROL_RATE);
+    double low = 0.0;
+    double high = 0.0;
+    for (int i = 1; i < 4 * CONTROL_RATE; i++)
+    {
+        double c = cents(periods[i], exact_period_q8(69));
+        if (c < low) low = c;
+        if (c > high) high = c;
+    }
+    double depth = CONFIG_INTERRUPT_VIBRATO_DEPTH_CENTS;
+    CHECK(high <= depth + MAX_CENTS && low >= -depth - MAX_CENTS,
+          "vibrato %.3f..%.3f cents, depth %.0f", low, high, depth);
+    CHECK(high >= 0.99 * depth && low <= -0.99 * depth,
+          "vibrato %.3f..%.3f cents, depth %.0f", low, high, depth);
+}
+
+// Presets come from bank images built off target, the coil limits hold
+static void check_patch_limits(void)
+{
+    bank_preset_t preset;
+    bank_preset_default(&preset);
+    preset.pd_max_us = 1000;
+    preset.max_duty = 90;
+
+    voice_patch_t patch;
+    voice_patch_compile(&patch, &preset);
+    CHECK(patch.pd_max ==
+              CONFIG_INTERRUPT_PD_MAX * (VOICE_TICK_HZ / 1000000),
+          "pd_max %u ticks above the limit", patch.pd_max);
+    CHECK(patch.max_duty == CONFIG_INTERRUPT_MAX_DUTY,
+          "max_duty %u%% above the limit", patch.max_duty);
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+int main(void)
+{
+    voice_init(CONTROL_RATE);
+    check_pitch_sweep();
+    check_tick_periods();
+    check_patch_limits();
+    return CHECK_DONE();
+}